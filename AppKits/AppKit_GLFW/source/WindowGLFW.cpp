@@ -46,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AppKit_GLFW/WindowGLFW.H"
 #include <iostream>
 #include "log/Logger.h"
+#include "log/LogRateLimiter.h"
 
 namespace MinVR {
 
@@ -55,6 +56,8 @@ using namespace std;
 
 std::map<GLFWwindow*, WindowRef> WindowGLFW::pointerToObjectMap(WindowGLFW::initPointerToObjectMap()); 
 
+bool WindowGLFW::glewInitialized = false;
+
 std::map<GLFWwindow*, WindowRef> WindowGLFW::initPointerToObjectMap()
 {
 	std::map<GLFWwindow*, WindowRef> map;
@@ -200,6 +203,11 @@ WindowGLFW::~WindowGLFW()
 
 void WindowGLFW::initGLEW()
 {
+	// Windows are all created from the main thread, so a plain flag is enough here
+	if (glewInitialized) {
+		return;
+	}
+
 	// Initialize glew
 	// Requires that a context exists and is current before it will work, so we create a temporary one here
 	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
@@ -214,6 +222,7 @@ void WindowGLFW::initGLEW()
 	}
 	glfwMakeContextCurrent(NULL);
 	glfwDestroyWindow(tempWin);
+	glewInitialized = true;
 }
 
 void WindowGLFW::pollForInput(std::vector<EventRef> &events)
@@ -241,7 +250,7 @@ void WindowGLFW::makeContextCurrent()
 
 	GLenum err;
 	if((err = glGetError()) != GL_NO_ERROR) {
-		std::cout << "openGL ERROR  make context current: "<<err<<std::endl;
+		MINVR_LOG_RATE_LIMITED(LOGLEVEL_ERROR, "AppKit_GLFW", "openGL ERROR make context current: " << err);
 	}
 }
 
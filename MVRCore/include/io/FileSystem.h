@@ -46,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <string>
 #include <vector>
+#include <io/MappedFile.h>
 
 namespace MinVR {
 
@@ -57,6 +58,9 @@ public:
 	virtual bool exists(const std::string& fileName) = 0;
 	virtual std::string concatPath(const std::string& pathA, const std::string& pathB) = 0;
 	virtual std::vector<std::string> listDirectory(const std::string& path, bool directories) = 0;
+
+	// Maps the whole file read-only into memory.  Returns nullptr if the file can't be opened.
+	virtual MappedFileRef mapFile(const std::string& fileName);
 };
 
 } /* namespace MinVR */
@@ -0,0 +1,86 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/include/io/MappedFile.h
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+#include <memory>
+#include <cstddef>
+
+namespace MinVR {
+
+class MappedFile;
+typedef std::shared_ptr<MappedFile> MappedFileRef;
+
+/*! @brief A read-only view of a whole file mapped into memory.
+ *
+ *  The mapping is released when the object is destroyed, so getData() must not be used
+ *  after that.  The data is not null terminated; always use it together with getSize().
+ *  Create these through FileSystem::mapFile().
+ */
+class MappedFile {
+public:
+	MappedFile(const std::string& fileName);
+	virtual ~MappedFile();
+
+	bool isValid() const;
+	const char* getData() const;
+	size_t getSize() const;
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char* _data;
+	size_t _size;
+	bool _valid;
+#if defined(WIN32)
+	void* _file;
+	void* _mapping;
+#endif
+};
+
+} /* namespace MinVR */
+
+#endif /* MAPPEDFILE_H_ */
@@ -0,0 +1,106 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/include/log/AsyncLogger.h
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#ifndef ASYNCLOGGER_H_
+#define ASYNCLOGGER_H_
+
+#include <log/Logger.h>
+#include <MVRCore/Thread.h>
+#include <atomic>
+#include <vector>
+
+namespace MinVR {
+
+/// Hands messages to a background writer thread through a bounded
+/// multi-producer ring, so that logging never blocks the calling thread on
+/// the wrapped logger (and its disk or console I/O).  When the ring is full,
+/// messages are dropped and counted rather than waited on.  Failed asserts and
+/// flush() drain the ring first, and destroying the logger drains it too.
+class AsyncLogger : public Logger {
+public:
+	AsyncLogger(LoggerRef logger, int capacity = 1024);
+	virtual ~AsyncLogger();
+	void init();
+	void log(const std::string& message, const std::string& attributeName, const std::string& attributeValue);
+	void assertMessage(bool expression, const std::string& message);
+
+	/// Blocks until everything logged before the call has been written, then flushes the wrapped logger.
+	void flush();
+
+	/// Number of messages dropped so far because the ring was full.
+	unsigned long long getNumDropped() const;
+
+private:
+	struct Entry {
+		std::atomic<size_t> sequence;
+		std::string message;
+		std::string attributeName;
+		std::string attributeValue;
+	};
+
+	void run();
+	bool writePending();
+	void wakeWriter();
+
+	LoggerRef _logger;
+	std::vector<Entry> _ring;
+	size_t _mask;
+	std::atomic<size_t> _enqueuePos;
+	std::atomic<size_t> _dequeuePos;
+	std::atomic<unsigned long long> _numDropped;
+	unsigned long long _numDroppedReported;
+
+	std::atomic<bool> _writerSleeping;
+	std::atomic<bool> _running;
+	Mutex _wakeMutex;
+	ConditionVariable _wakeCond;
+	ConditionVariable _drainedCond;
+
+	// Serializes calls into the wrapped logger
+	Mutex _writeMutex;
+	Thread* _writer;
+};
+
+} /* namespace MinVR */
+
+#endif /* ASYNCLOGGER_H_ */
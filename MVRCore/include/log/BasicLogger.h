@@ -52,16 +52,20 @@ namespace MinVR {
 
 class BasicLogger : public Logger {
 public:
-	BasicLogger(std::ostream *stream = &std::cout);
-	BasicLogger(std::shared_ptr< std::ostream > stream);
+	BasicLogger(std::ostream *stream = &std::cout, bool autoFlush = true);
+	BasicLogger(std::shared_ptr< std::ostream > stream, bool autoFlush = true);
 	virtual ~BasicLogger();
 	void init();
 	void log(const std::string& message, const std::string& attributeName, const std::string& attributeValue);
 	void assertMessage(bool expression, const std::string& message);
+	void flush();
+	/// When set, the stream is flushed after every message.
+	void setAutoFlush(bool autoFlush);
 private:
 	inline std::ostream& getStream();
 	std::ostream* _ostream;
 	std::shared_ptr< std::ostream > _ostreamPtr;
+	bool _autoFlush;
 };
 
 } /* namespace MinVR */
@@ -56,6 +56,7 @@ public:
 	void init();
 	void log(const std::string& message, const std::string& attributeName, const std::string& attributeValue);
 	void assertMessage(bool expression, const std::string& message);
+	void flush();
 	void addLogger(LoggerRef logger);
 private:
 	std::vector<LoggerRef> _loggers;
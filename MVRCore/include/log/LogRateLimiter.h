@@ -0,0 +1,153 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/include/log/LogRateLimiter.h
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#ifndef LOGRATELIMITER_H_
+#define LOGRATELIMITER_H_
+
+#include <log/Logger.h>
+#include <MVRCore/Thread.h>
+#include <MVRCore/Time.h>
+#include <unordered_map>
+#include <vector>
+
+namespace MinVR {
+
+/// Keeps a call site that fires every frame from flooding the log.  Each call
+/// site logs at most maxPerInterval messages per interval, counting both new
+/// messages and repeats, and a message is repeated at most once per interval.
+/// Repeats that were held back are reported as "message (repeated N times)",
+/// and new messages that were held back by a count per call site.  Counts are
+/// logged when the interval ends, by the next call or by update(), and flush()
+/// logs them right away.  The destructor flushes, so counts pending at exit
+/// are logged as well.  Normally used through MINVR_LOG_RATE_LIMITED, which
+/// keys the messages by the file and line of the macro.
+class LogRateLimiter {
+public:
+	LogRateLimiter(double intervalSeconds = 5.0, int maxPerInterval = 10);
+	~LogRateLimiter();
+
+	/// The limiter used by MINVR_LOG_RATE_LIMITED
+	static LogRateLimiter& getInstance();
+
+	/// Logs message now if the limits allow it, along with any counts that
+	/// are due.  file and line identify the call site, file is compared by
+	/// address so it should be a string literal like __FILE__.
+	void log(LogLevel level, const char* tag, const char* file, int line, const std::string& message);
+
+	/// Logs the counts that are due if the interval has ended.  The engine
+	/// calls this once per frame, so the count of a flood that stops is
+	/// logged without waiting for another message.
+	void update();
+
+	/// Logs all pending counts now.
+	void flush();
+
+private:
+	struct Entry {
+		LogLevel level;
+		std::string tag;
+		int suppressed;
+		TimeStamp lastLogged;
+	};
+
+	struct SiteKey {
+		const char* file;
+		int line;
+		bool operator==(const SiteKey& other) const { return file == other.file && line == other.line; }
+	};
+
+	struct SiteKeyHash {
+		size_t operator()(const SiteKey& key) const { return std::hash<const void*>()(key.file) ^ std::hash<int>()(key.line); }
+	};
+
+	struct Site {
+		int loggedThisInterval;
+		// New messages held back by the limit, with the level and tag of the last one
+		int dropped;
+		LogLevel droppedLevel;
+		std::string droppedTag;
+		std::unordered_map<std::string, Entry> entries;
+	};
+
+	struct Line {
+		LogLevel level;
+		std::string tag;
+		std::string text;
+	};
+
+	typedef std::unordered_map<SiteKey, Site, SiteKeyHash> SiteTable;
+
+	// Starts a new interval if the current one has ended, adding the counts that are due to lines
+	void updateInterval(const TimeStamp& now, std::vector<Line>& lines);
+
+	// Adds the pending counts of all sites to lines, and forgets the entries
+	// that have nothing pending when forget is true
+	void flush(const TimeStamp& now, bool forget, std::vector<Line>& lines);
+	void addLine(const std::string& message, const Entry& entry, std::vector<Line>& lines);
+	static void writeLines(const std::vector<Line>& lines);
+
+	Mutex _mutex;
+	SiteTable _sites;
+	size_t _numEntries;
+	double _interval;
+	int _maxPerInterval;
+	TimeStamp _intervalStart;
+};
+
+/// Logs through LogRateLimiter::getInstance(), called by MINVR_LOG_RATE_LIMITED
+void logRateLimited(LogLevel level, const char* tag, const char* file, int line, const std::string& message);
+
+} /* namespace MinVR */
+
+/// Like MINVR_LOG, but filtered through LogRateLimiter, with the call site
+/// given by the file and line of the macro.
+#define MINVR_LOG_RATE_LIMITED(level, tag, message) \
+	do { \
+		if ((level) >= MINVR_LOG_COMPILE_FLOOR && MinVR::Logger::isEnabled((level), (tag))) { \
+			std::ostringstream minvrLogStream; \
+			minvrLogStream << message; \
+			MinVR::logRateLimited((level), (tag), __FILE__, __LINE__, minvrLogStream.str()); \
+		} \
+	} while (0)
+
+#endif /* LOGRATELIMITER_H_ */
@@ -46,12 +46,23 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <string>
 #include <memory>
+#include <sstream>
+#include <atomic>
 
 namespace MinVR {
 
 class Logger;
 typedef std::shared_ptr<Logger> LoggerRef;
 
+enum LogLevel {
+	LOGLEVEL_TRACE = 0,
+	LOGLEVEL_DEBUG,
+	LOGLEVEL_INFO,
+	LOGLEVEL_WARNING,
+	LOGLEVEL_ERROR,
+	LOGLEVEL_OFF
+};
+
 class Logger {
 public:
 	virtual ~Logger();
@@ -61,10 +72,61 @@ public:
 	virtual void init() = 0;
 	virtual void log(const std::string& message, const std::string& attributeName, const std::string& attributeValue) = 0;
 	virtual void assertMessage(bool expression, const std::string& message) = 0;
+	/// Makes sure everything logged so far has been written out.
+	virtual void flush();
+
+	/// Logs message with the level name prepended.  Doesn't check the
+	/// thresholds, use the MINVR_LOG macros for that.
+	void logAtLevel(LogLevel level, const std::string& message, const std::string& tag);
+
+	/// Sets the runtime threshold for tags that don't have their own.
+	static void setLevel(LogLevel level);
+	/// Sets the runtime threshold for a single tag.
+	static void setLevel(const std::string& tag, LogLevel level);
+	/// Returns true if a message at level for tag would be logged.  Levels below
+	/// every threshold are rejected with a single atomic load.
+	static inline bool isEnabled(LogLevel level, const char* tag) {
+		return level >= _minLevel.load(std::memory_order_relaxed) && isEnabledForTag(level, tag);
+	}
+
+	static const char* getLevelName(LogLevel level);
+	/// Parses Trace, Debug, Info, Warning, Error or Off (case insensitive).
+	static bool parseLevel(const std::string& name, LogLevel& level);
+
 private:
+	static bool isEnabledForTag(LogLevel level, const char* tag);
+
 	static LoggerRef _instance;
+	static std::atomic<int> _minLevel;
 };
 
 } /* namespace MinVR */
 
+// Levels below the floor are compiled out of the MINVR_LOG macros.  Release
+// builds drop trace and debug messages unless the floor is defined otherwise.
+#ifndef MINVR_LOG_COMPILE_FLOOR
+#ifdef MinVR_DEBUG
+#define MINVR_LOG_COMPILE_FLOOR MinVR::LOGLEVEL_TRACE
+#else
+#define MINVR_LOG_COMPILE_FLOOR MinVR::LOGLEVEL_INFO
+#endif
+#endif
+
+// message may be any sequence of stream insertions, e.g. "Key " << key.  It
+// is only evaluated when the level is enabled for tag.
+#define MINVR_LOG(level, tag, message) \
+	do { \
+		if ((level) >= MINVR_LOG_COMPILE_FLOOR && MinVR::Logger::isEnabled((level), (tag))) { \
+			std::ostringstream minvrLogStream; \
+			minvrLogStream << message; \
+			MinVR::Logger::getInstance().logAtLevel((level), minvrLogStream.str(), (tag)); \
+		} \
+	} while (0)
+
+#define MINVR_LOG_TRACE(tag, message) MINVR_LOG(MinVR::LOGLEVEL_TRACE, tag, message)
+#define MINVR_LOG_DEBUG(tag, message) MINVR_LOG(MinVR::LOGLEVEL_DEBUG, tag, message)
+#define MINVR_LOG_INFO(tag, message) MINVR_LOG(MinVR::LOGLEVEL_INFO, tag, message)
+#define MINVR_LOG_WARNING(tag, message) MINVR_LOG(MinVR::LOGLEVEL_WARNING, tag, message)
+#define MINVR_LOG_ERROR(tag, message) MINVR_LOG(MinVR::LOGLEVEL_ERROR, tag, message)
+
 #endif /* LOGGER_H_ */
@@ -0,0 +1,190 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/include/log/TraceLog.h
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#ifndef TRACELOG_H_
+#define TRACELOG_H_
+
+#include <string>
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+namespace MinVR {
+
+/// A binary log for hot paths.  A trace point stores the ID of its format
+/// string, a timestamp and the raw bytes of its arguments in a buffer owned by
+/// the calling thread.  Nothing is formatted while the program runs.  Full
+/// buffers are appended to the trace file, and tools/decodeTraceLog turns the
+/// file back into text.  Use the MINVR_TRACE macro rather than write().
+///
+/// File layout (native byte order): the 8 byte magic "MVRTRACE" and a uint32
+/// version, followed by blocks.  A format block is BLOCK_FORMAT, uint32 id,
+/// uint32 line, then the source file and format string as uint16 length
+/// prefixed strings.  A data block is BLOCK_DATA, uint32 thread index and
+/// uint32 byte count, followed by records.  A record is uint32 format id,
+/// uint64 nanoseconds since the trace was opened, uint8 argument count, and
+/// for each argument a type byte and its value.  Strings are a uint16 length
+/// followed by the bytes.
+class TraceLog {
+public:
+	enum BlockType {
+		BLOCK_FORMAT = 1,
+		BLOCK_DATA = 2
+	};
+
+	enum ArgType {
+		ARG_INT64 = 1,
+		ARG_UINT64,
+		ARG_DOUBLE,
+		ARG_BOOL,
+		ARG_STRING,
+		ARG_POINTER
+	};
+
+	static const uint32_t VERSION = 1;
+
+	/// Starts tracing to filename, replacing its contents.  Returns false if the file can't be created.
+	static bool open(const std::string& filename);
+	/// Writes out all buffers and stops tracing.
+	static void close();
+	/// Writes out the buffers of every thread.
+	static void flush();
+
+	static inline bool isEnabled() {
+		return _enabled.load(std::memory_order_relaxed);
+	}
+
+	/// Returns the ID for a format string.  Each trace point calls this once.
+	static uint32_t registerFormat(const char* format, const char* file, int line);
+
+	template<typename... Args>
+	static void write(uint32_t formatId, const Args&... args) {
+		size_t size = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint8_t) + encodedSize(args...);
+		char* out = beginRecord(size);
+		if (out == nullptr) {
+			return;
+		}
+		uint64_t timestamp = getTimestamp();
+		memcpy(out, &formatId, sizeof(formatId));
+		out += sizeof(formatId);
+		memcpy(out, &timestamp, sizeof(timestamp));
+		out += sizeof(timestamp);
+		*out++ = (char)sizeof...(Args);
+		encode(out, args...);
+		endRecord();
+	}
+
+private:
+	static char* beginRecord(size_t size);
+	static void endRecord();
+	static uint64_t getTimestamp();
+
+	static std::atomic<bool> _enabled;
+
+	static inline size_t encodedSize() { return 0; }
+	template<typename T, typename... Rest>
+	static inline size_t encodedSize(const T& arg, const Rest&... rest) {
+		return argSize(arg) + encodedSize(rest...);
+	}
+
+	static inline void encode(char*) {}
+	template<typename T, typename... Rest>
+	static inline void encode(char* out, const T& arg, const Rest&... rest) {
+		encode(putArg(out, arg), rest...);
+	}
+
+	template<typename T>
+	static inline char* putValue(char* out, ArgType type, T value) {
+		*out++ = (char)type;
+		memcpy(out, &value, sizeof(T));
+		return out + sizeof(T);
+	}
+
+	static inline size_t stringSize(size_t length) { return 1 + sizeof(uint16_t) + (length < 0xFFFF ? length : 0xFFFF); }
+	static inline char* putString(char* out, const char* str, size_t length) {
+		uint16_t len = (uint16_t)(length < 0xFFFF ? length : 0xFFFF);
+		*out++ = (char)ARG_STRING;
+		memcpy(out, &len, sizeof(len));
+		memcpy(out + sizeof(len), str, len);
+		return out + sizeof(len) + len;
+	}
+
+	static inline size_t argSize(int) { return 1 + sizeof(int64_t); }
+	static inline size_t argSize(long) { return 1 + sizeof(int64_t); }
+	static inline size_t argSize(long long) { return 1 + sizeof(int64_t); }
+	static inline size_t argSize(unsigned int) { return 1 + sizeof(uint64_t); }
+	static inline size_t argSize(unsigned long) { return 1 + sizeof(uint64_t); }
+	static inline size_t argSize(unsigned long long) { return 1 + sizeof(uint64_t); }
+	static inline size_t argSize(double) { return 1 + sizeof(double); }
+	static inline size_t argSize(bool) { return 2; }
+	static inline size_t argSize(const void*) { return 1 + sizeof(uint64_t); }
+	static inline size_t argSize(const char* str) { return stringSize(str == nullptr ? 0 : strlen(str)); }
+	static inline size_t argSize(const std::string& str) { return stringSize(str.size()); }
+
+	static inline char* putArg(char* out, int value) { return putValue(out, ARG_INT64, (int64_t)value); }
+	static inline char* putArg(char* out, long value) { return putValue(out, ARG_INT64, (int64_t)value); }
+	static inline char* putArg(char* out, long long value) { return putValue(out, ARG_INT64, (int64_t)value); }
+	static inline char* putArg(char* out, unsigned int value) { return putValue(out, ARG_UINT64, (uint64_t)value); }
+	static inline char* putArg(char* out, unsigned long value) { return putValue(out, ARG_UINT64, (uint64_t)value); }
+	static inline char* putArg(char* out, unsigned long long value) { return putValue(out, ARG_UINT64, (uint64_t)value); }
+	static inline char* putArg(char* out, double value) { return putValue(out, ARG_DOUBLE, value); }
+	static inline char* putArg(char* out, bool value) { *out++ = (char)ARG_BOOL; *out++ = value ? 1 : 0; return out; }
+	static inline char* putArg(char* out, const void* value) { return putValue(out, ARG_POINTER, (uint64_t)(uintptr_t)value); }
+	static inline char* putArg(char* out, const char* str) { return putString(out, str == nullptr ? "" : str, str == nullptr ? 0 : strlen(str)); }
+	static inline char* putArg(char* out, const std::string& str) { return putString(out, str.c_str(), str.size()); }
+};
+
+} /* namespace MinVR */
+
+/// Records a trace point when a trace file is open.  "{}" in format is
+/// replaced by the next argument when the trace is decoded.  format must be a
+/// string literal, it is stored once per call site rather than per call.
+#define MINVR_TRACE(format, ...) \
+	do { \
+		if (MinVR::TraceLog::isEnabled()) { \
+			static const uint32_t minvrTraceFormatId = MinVR::TraceLog::registerFormat(format, __FILE__, __LINE__); \
+			MinVR::TraceLog::write(minvrTraceFormatId, ##__VA_ARGS__); \
+		} \
+	} while (0)
+
+#endif /* TRACELOG_H_ */
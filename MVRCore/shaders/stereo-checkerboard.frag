@@ -43,16 +43,26 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ================================================================================ */
 
+/* The eye textures hold every other column of the window.  The texel in column floor(x/2) is
+   shown on both window columns 2*floor(x/2) and 2*floor(x/2)+1 of alternating rows. */
 
-#version 130
-#extension GL_EXT_gpu_shader4 : enable
-/* Version 130 is needed for the xor operation */
-
+#ifdef MINVR_EYE_TEXTURE_ARRAY
+// Single pass stereo renders both eyes to the layers of one texture array
+#extension GL_EXT_texture_array : enable
+uniform sampler2DArray eyeTextures;
+vec4 leftEyeColor(vec2 texCoord) { return texture2DArray(eyeTextures, vec3(texCoord, 0.0)); }
+vec4 rightEyeColor(vec2 texCoord) { return texture2DArray(eyeTextures, vec3(texCoord, 1.0)); }
+#else
 uniform sampler2D rightEyeTexture;
-uniform sampler2D leftEyeTexture;  
-uniform vec2 screenSize;
+uniform sampler2D leftEyeTexture;
+vec4 leftEyeColor(vec2 texCoord) { return texture2D(leftEyeTexture, texCoord); }
+vec4 rightEyeColor(vec2 texCoord) { return texture2D(rightEyeTexture, texCoord); }
+#endif
+uniform vec2 eyeTextureSize;
 
 void main(void){
-	ivec2 test = step(0.5 , floor(mod(gl_TexCoord[0].xy * screenSize.xy, 2.0));
-	gl_FragColor = mix(texture2D(leftEyeTexture,  gl_TexCoord[0].xy), texture2D(rightEyeTexture, gl_TexCoord[0].xy), test.x^test.y);
+	vec2 pixel = floor(gl_FragCoord.xy);
+	vec2 texCoord = vec2((floor(pixel.x * 0.5) + 0.5) / eyeTextureSize.x, (pixel.y + 0.5) / eyeTextureSize.y);
+	vec2 odd = pixel - 2.0 * floor(pixel * 0.5);
+	gl_FragColor = mix(leftEyeColor(texCoord), rightEyeColor(texCoord), abs(odd.x - odd.y));
 }
\ No newline at end of file
@@ -43,12 +43,26 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ================================================================================ */
 
+/* The eye textures hold every other row of the window, the left eye's even rows and the
+   right eye's odd rows. */
 
+#ifdef MINVR_EYE_TEXTURE_ARRAY
+// Single pass stereo renders both eyes to the layers of one texture array
+#extension GL_EXT_texture_array : enable
+uniform sampler2DArray eyeTextures;
+vec4 leftEyeColor(vec2 texCoord) { return texture2DArray(eyeTextures, vec3(texCoord, 0.0)); }
+vec4 rightEyeColor(vec2 texCoord) { return texture2DArray(eyeTextures, vec3(texCoord, 1.0)); }
+#else
 uniform sampler2D rightEyeTexture;
-uniform sampler2D leftEyeTexture;  
-uniform vec2 screenSize;
+uniform sampler2D leftEyeTexture;
+vec4 leftEyeColor(vec2 texCoord) { return texture2D(leftEyeTexture, texCoord); }
+vec4 rightEyeColor(vec2 texCoord) { return texture2D(rightEyeTexture, texCoord); }
+#endif
+uniform vec2 eyeTextureSize;
 
 void main(void){
-	float test = step(0.5 , floor(mod(gl_TexCoord[0].y * screenSize.y, 2.0));
-	gl_FragColor = mix(texture2D(leftEyeTexture,  gl_TexCoord[0].xy), texture2D(rightEyeTexture, gl_TexCoord[0].xy), test);
+	vec2 pixel = floor(gl_FragCoord.xy);
+	float row = floor(pixel.y * 0.5);
+	vec2 texCoord = vec2((pixel.x + 0.5) / eyeTextureSize.x, (row + 0.5) / eyeTextureSize.y);
+	gl_FragColor = mix(leftEyeColor(texCoord), rightEyeColor(texCoord), pixel.y - 2.0 * row);
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and 
+maintained collaboratively by the University of Minnesota's Interactive 
+Visualization Lab and the Brown University Visualization Research Lab.
+
+File: MinVR/MVRCore/include/MVRCore/shaders/stereo-mask.frag
+
+Original Author(s) of this File: 
+	MinVR Development Team, 2015, University of Minnesota
+	
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2008-2015 Regents of the University of Minnesota and Brown University
+Copyright (c) 2004-2008 Brown University
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the University of Minnesota, Brown University, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+
+/* Writes the interleave pattern of the stereo type into the stencil buffer.  Fragments
+   for the left eye are discarded, so only right eye pixels get the stencil reference value.
+   pattern is 0 for checkerboard, 1 for interlaced columns and 2 for interlaced rows and
+   matches the selection made by the stereo-*.frag composite shaders. */
+
+uniform int pattern;
+
+void main(void){
+	vec2 odd = step(0.5, mod(floor(gl_FragCoord.xy), 2.0));
+	float rightEye;
+	if (pattern == 0) {
+		rightEye = abs(odd.x - odd.y);
+	}
+	else if (pattern == 1) {
+		rightEye = odd.x;
+	}
+	else {
+		rightEye = odd.y;
+	}
+	if (rightEye < 0.5) {
+		discard;
+	}
+	gl_FragColor = vec4(0.0);
+}
\ No newline at end of file
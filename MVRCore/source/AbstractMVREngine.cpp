@@ -51,15 +51,22 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <io/FileSystem.h>
 #include <fstream>
 #include "MVRCore/GraphicsContext.H"
+#include "MVRCore/Statistics.H"
+#include <log/TraceLog.h>
+#include <log/LogRateLimiter.h>
+#include <iomanip>
 
 namespace MinVR {
 
-AbstractMVREngine::AbstractMVREngine() : _pluginManager(this), contextVersion({3,3})
+AbstractMVREngine::AbstractMVREngine() : _pluginManager(this), contextVersion({3,3}), _startupReported(false)
 {
+	_initStartTime = getCurrentTime();
 }
 
 AbstractMVREngine::~AbstractMVREngine()
 {
+	LogRateLimiter::getInstance().flush();
+	TraceLog::close();
 	GraphicsContext::cleanup();
 }
 
@@ -67,32 +74,118 @@ AbstractMVREngine::~AbstractMVREngine()
 void AbstractMVREngine::initializeLogging()
 {
 	MinVR::Logger::getInstance().init();
-	MinVR::Logger::getInstance().log("started logger", "tag", "MVRCore");
+	MINVR_LOG_INFO("MVRCore", "started logger");
+}
+
+void AbstractMVREngine::configureLogLevels()
+{
+	ConfigMap::Snapshot snapshot = _configMap->getSnapshot();
+	const std::string prefix = "LogLevel";
+	for (ConfigMap::Table::const_iterator it = snapshot->begin(); it != snapshot->end(); ++it) {
+		if (it->first.compare(0, prefix.size(), prefix) != 0) {
+			continue;
+		}
+
+		LogLevel level;
+		if (!Logger::parseLevel(it->second, level)) {
+			MINVR_LOG_WARNING("MVRCore", "Unknown log level '" << it->second << "' for " << it->first);
+		}
+		else if (it->first == prefix) {
+			Logger::setLevel(level);
+		}
+		else if (it->first.size() > prefix.size() + 1 && it->first[prefix.size()] == '_') {
+			Logger::setLevel(it->first.substr(prefix.size() + 1), level);
+		}
+	}
 }
 
 void AbstractMVREngine::init(int argc, char **argv)
 {
+	_initStartTime = getCurrentTime();
+	TimeStamp start = _initStartTime;
 	initializeLogging();
+	recordStartupPhase("Logger", start);
+
+	start = getCurrentTime();
 	_configMap.reset(new ConfigMap(argc, argv, false));
 	ConfigValMap::map = _configMap;
+	recordStartupPhase("ConfigMap", start);
 
 	_syncTimeStart = getCurrentTime();
 
-	setupPlugins();
-	setupWindowsAndViewports();
-	setupInputDevices();
+	setupPluginsWindowsAndInputDevices();
 }
 
 void AbstractMVREngine::init(ConfigMapRef configMap)
 {
+	_initStartTime = getCurrentTime();
 	_configMap = configMap;
 	ConfigValMap::map = _configMap;
 
 	_syncTimeStart = getCurrentTime();
 
+	setupPluginsWindowsAndInputDevices();
+}
+
+void AbstractMVREngine::setupPluginsWindowsAndInputDevices()
+{
+	configureLogLevels();
+
+	std::string traceLogFile = _configMap->get("TraceLogFile", "");
+	if (traceLogFile != "" && !TraceLog::open(traceLogFile)) {
+		MINVR_LOG_ERROR("MVRCore", "Unable to open trace log " << traceLogFile);
+	}
+
+	if (_configMap->get("ConcurrentStartup", false)) {
+		// Window creation stays on this thread since most windowing toolkits require it
+		Thread devicesThread(&AbstractMVREngine::setupPluginsAndInputDevices, this);
+		TimeStamp start = getCurrentTime();
+		setupWindowsAndViewports();
+		recordStartupPhase("WindowsAndViewports", start);
+		devicesThread.join();
+	}
+	else {
+		TimeStamp start = getCurrentTime();
+		setupPlugins();
+		recordStartupPhase("Plugins", start);
+
+		start = getCurrentTime();
+		setupWindowsAndViewports();
+		recordStartupPhase("WindowsAndViewports", start);
+
+		start = getCurrentTime();
+		setupInputDevices();
+		recordStartupPhase("InputDevices", start);
+	}
+}
+
+void AbstractMVREngine::setupPluginsAndInputDevices()
+{
+	TimeStamp start = getCurrentTime();
 	setupPlugins();
-	setupWindowsAndViewports();
+	recordStartupPhase("Plugins", start);
+
+	start = getCurrentTime();
 	setupInputDevices();
+	recordStartupPhase("InputDevices", start);
+}
+
+void AbstractMVREngine::recordStartupPhase(const std::string &name, const TimeStamp &start)
+{
+	Statistics::getInstance().setValue("Startup." + name, getDurationSeconds(getDuration(getCurrentTime(), start)));
+}
+
+void AbstractMVREngine::printStartupReport()
+{
+	std::vector<std::string> phases = Statistics::getInstance().getNames("Startup.");
+	std::stringstream report;
+	report << "Startup report:";
+	for (int i=0;i<phases.size();i++) {
+		report << std::endl << "\t" << phases[i].substr(8) << ": "
+			<< std::fixed << std::setprecision(1) << Statistics::getInstance().getValue(phases[i]) * 1000.0 << " ms";
+	}
+	report << std::endl << "\tData file probes: " << DataFileUtils::getNumFileSystemProbes();
+	MINVR_LOG_INFO("MVRCore", report.str());
 }
 
 void AbstractMVREngine::setupPlugins()
@@ -147,6 +240,18 @@ void AbstractMVREngine::setupWindowsAndViewports()
 		wSettings->visible      = _configMap->get(winStr + "Visible", wSettings->visible);
 		wSettings->useGPUAffinity = _configMap->get(winStr + "UseGPUAffinity", wSettings->useGPUAffinity);
 		wSettings->stereo		= _configMap->get(winStr + "Stereo", wSettings->stereo);
+		wSettings->singlePassStereo = _configMap->get(winStr + "SinglePassStereo", wSettings->singlePassStereo);
+		wSettings->dynamicResolution = _configMap->get(winStr + "DynamicResolution", wSettings->dynamicResolution);
+		wSettings->targetFrameRate = _configMap->get(winStr + "TargetFrameRate", wSettings->targetFrameRate);
+		wSettings->minResolutionScale = _configMap->get(winStr + "MinResolutionScale", wSettings->minResolutionScale);
+		wSettings->maxResolutionScale = _configMap->get(winStr + "MaxResolutionScale", wSettings->maxResolutionScale);
+		if (wSettings->dynamicResolution && (wSettings->targetFrameRate <= 0.0 || wSettings->minResolutionScale <= 0.0 ||
+			wSettings->minResolutionScale > wSettings->maxResolutionScale)) {
+			std::stringstream ss;
+			ss << "Fatal error: " + winStr + "DynamicResolution needs a positive TargetFrameRate and 0 < MinResolutionScale <= MaxResolutionScale";
+			Logger::getInstance().assertMessage(false, ss.str().c_str());
+		}
+		wSettings->frameTimers = _configMap->get(winStr + "FrameTimers", wSettings->frameTimers);
 		wSettings->contextVersion = contextVersion;
 
 		//wSettings.mouseVisible = _configMap->get(winStr + "MouseVisible", wSettings.mouseVisible);
@@ -176,6 +281,19 @@ void AbstractMVREngine::setupWindowsAndViewports()
 			Logger::getInstance().assertMessage(false, ss.str().c_str());
 		}
 
+		std::string compositeStr = _configMap->get(winStr + "StereoComposite", "Texture");
+		if (compositeStr == "Texture") {
+			wSettings->stereoComposite = WindowSettings::STEREOCOMPOSITE_TEXTURE;
+		}
+		else if (compositeStr == "Stencil") {
+			wSettings->stereoComposite = WindowSettings::STEREOCOMPOSITE_STENCIL;
+		}
+		else {
+			std::stringstream ss;
+			ss << "Fatal error: Unrecognized value for " + winStr + "StereoComposite: " + compositeStr;
+			Logger::getInstance().assertMessage(false, ss.str().c_str());
+		}
+
 
 		// Within each window, you can have multiple viewports.  Each viewport will render
 		// with a separate projection matrix, so this is used for drawing left and right eyes
@@ -195,14 +313,16 @@ void AbstractMVREngine::setupWindowsAndViewports()
 			wSettings->viewports.push_back(MinVR::Rect2D::xywh(x,y,width,height));
 
 			std::string cameraStr = _configMap->get(viewportStr + "CameraType", "OffAxis");
-			if (cameraStr == "OffAxis") {
+			if (cameraStr == "OffAxis" || cameraStr == "OffAxisFloat") {
 				glm::dvec3 topLeft  = _configMap->get(viewportStr + "TopLeft", glm::dvec3(-1.0, 1.0, 0.0));
 				glm::dvec3 topRight = _configMap->get(viewportStr + "TopRight", glm::dvec3(1.0, 1.0, 0.0));
 				glm::dvec3 botLeft  = _configMap->get(viewportStr + "BotLeft", glm::dvec3(-1.0, -1.0, 0.0));
 				glm::dvec3 botRight = _configMap->get(viewportStr + "BotRight", glm::dvec3(1.0, -1.0, 0.0));
 				double nearClip = _configMap->get(viewportStr + "NearClip", 0.01);
 				double farClip  = _configMap->get(viewportStr + "FarClip", 1000.0);
-				AbstractCameraRef cam(new CameraOffAxis(topLeft, topRight, botLeft, botRight, initialHeadFrame, interOcularDistance, nearClip, farClip, wSettings->contextVersion.isCoreProfile()));
+				CameraOffAxis* offAxis = new CameraOffAxis(topLeft, topRight, botLeft, botRight, initialHeadFrame, interOcularDistance, nearClip, farClip, wSettings->contextVersion.isCoreProfile());
+				offAxis->setSinglePrecision(cameraStr == "OffAxisFloat");
+				AbstractCameraRef cam(offAxis);
 				cameras.push_back(cam);
 			}
 			else if (cameraStr == "Traditional") {
@@ -216,7 +336,9 @@ void AbstractMVREngine::setupWindowsAndViewports()
 			}
 		}
 
+		TimeStamp start = getCurrentTime();
 		WindowRef window = createWindow(wSettings, cameras);
+		recordStartupPhase("CreateWindow" + intToString(w+1), start);
 		_windows.push_back(window);
 	}
 
@@ -309,6 +431,7 @@ void AbstractMVREngine::runApp(AbstractMVRAppRef app)
 
 void AbstractMVREngine::updateFrame()
 {
+	LogRateLimiter::getInstance().update();
 	pollUserInput();
 	updateProjectionForHeadTracking();
 
@@ -363,6 +486,15 @@ void AbstractMVREngine::runOneFrameOfApp(AbstractMVRAppRef app)
 	//std::cout << "All threads finished rendering"<<std::endl;
 	RenderThread::numThreadsReceivedRenderingComplete = 0;
 	renderingCompleteLock.unlock();
+
+	MINVR_TRACE("Frame {} complete with {} events", _frameCount, _events.size());
+	_frameCount++;
+
+	if (!_startupReported) {
+		recordStartupPhase("TimeToFirstFrame", _initStartTime);
+		printStartupReport();
+		_startupReported = true;
+	}
 }
 
 void AbstractMVREngine::pollUserInput()
@@ -374,6 +506,12 @@ void AbstractMVREngine::pollUserInput()
 	for (int i=0;i<_inputDevices.size();i++) { 
 		_inputDevices[i]->pollForInput(_events);
 	}
+
+	if (TraceLog::isEnabled()) {
+		for (int i=0;i<_events.size();i++) {
+			MINVR_TRACE("Event {}", _events[i]->getName());
+		}
+	}
 	
 	//TODO: ideally we want to sort the events by time stamp, but this seems to be flipping some tracker events
 	// out of order. Currently we get better results not sorting. Still needs to be debugged
@@ -391,6 +529,8 @@ void AbstractMVREngine::updateProjectionForHeadTracking()
 		for (int j=0;j<_windows.size();j++) {
 			_windows[j]->updateHeadTrackingForAllViewports(_events[i]->getCoordinateFrameData());
 		}
+		Statistics::getInstance().setValue("Camera.Updates", CameraOffAxis::getNumUpdates());
+		Statistics::getInstance().setValue("Camera.SkippedUpdates", CameraOffAxis::getNumSkippedUpdates());
 	}
 } 
 
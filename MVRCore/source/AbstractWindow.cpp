@@ -61,6 +61,17 @@ AbstractWindow::~AbstractWindow()
 
 void AbstractWindow::updateHeadTrackingForAllViewports(glm::dmat4 headFrame)
 {
+	if (CameraOffAxisBatch::canBatch(_cameras)) {
+		// Cameras that render in single precision don't need double precision matrices
+		bool singlePrecision = true;
+		for (int i=0;i<_cameras.size();i++) {
+			singlePrecision = singlePrecision && static_cast<CameraOffAxis*>(_cameras[i].get())->isSinglePrecision();
+		}
+		_cameraBatch.setSinglePrecision(singlePrecision);
+		_cameraBatch.updateHeadTrackingFrame(_cameras, headFrame);
+		return;
+	}
+
 	for (int i=0;i<_cameras.size();i++) {
 		_cameras[i]->updateHeadTrackingFrame(headFrame);
 	}
@@ -71,13 +71,15 @@ std::vector<std::string> BoostFileSystem::listDirectory(const std::string& path,
 
 	std::vector<std::string> files;
 
-	for (directory_iterator itr(path); itr!=directory_iterator(); ++itr)
+	// A directory that can't be opened simply has no entries
+	boost::system::error_code error;
+	for (directory_iterator itr(path, error); !error && itr!=directory_iterator(); itr.increment(error))
 	{
 		if (directories && is_directory(itr->path()))
 		{
 			files.push_back(itr->path().filename().string());
 		}
-		else if (is_regular_file(path))
+		else if (is_regular_file(itr->path()))
 		{
 			files.push_back(itr->path().filename().string());
 		}
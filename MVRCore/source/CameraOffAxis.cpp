@@ -45,6 +45,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "MVRCore/CameraOffAxis.H"
+#include <string.h>
+#include <glm/gtc/type_ptr.hpp>
 #ifdef WIN32
 #define NOMINMAX
 #include <windows.h>
@@ -61,9 +63,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace MinVR
 {
 
+std::atomic<unsigned long> CameraOffAxis::_numUpdates(0);
+std::atomic<unsigned long> CameraOffAxis::_numSkippedUpdates(0);
+
 CameraOffAxis::CameraOffAxis(glm::dvec3 topLeft, glm::dvec3 topRight, glm::dvec3 botLeft, glm::dvec3 botRight,
 	glm::dmat4 initialHeadFrame, double interOcularDistance, 
-	double nearClipDist, double farClipDist, bool isCoreProfile) : AbstractCamera(), _isCoreProfile(isCoreProfile)
+	double nearClipDist, double farClipDist, bool isCoreProfile) : AbstractCamera(), _isCoreProfile(isCoreProfile), _matricesValid(false),
+	_object2WorldIsIdentity(true), _singlePrecision(false), _currentEye(-1), _applyingEye(-1), _projectionOffsetEnabled(false), _currentProjectionOffset(false)
 {
 	_topLeft = topLeft;
 	_topRight = topRight;
@@ -92,15 +98,36 @@ CameraOffAxis::CameraOffAxis(glm::dvec3 topLeft, glm::dvec3 topRight, glm::dvec3
 	//					x.z, y.z, z.z, center.z,
 	//					0.0, 0.0, 0.0, 1);
 	_room2tile = glm::inverse(tile2room);
+
+	for (int i = 0; i <= NUM_EYES; i++) {
+		_frustumValid[i] = false;
+	}
 }
 
 CameraOffAxis::~CameraOffAxis()
 {
 }
 
+bool CameraOffAxis::needsUpdate(const glm::dmat4& newHeadFrame) const
+{
+	// Trackers that are paused or absent report bit-identical frames, so an exact comparison is enough
+	return !_matricesValid || memcmp(&newHeadFrame, &_headFrame, sizeof(glm::dmat4)) != 0 ||
+		_iod != _computedIod || _nearClip != _computedNearClip || _farClip != _computedFarClip;
+}
+
 void CameraOffAxis::updateHeadTrackingFrame(glm::dmat4 newHeadFrame)
 {
+	if (!needsUpdate(newHeadFrame)) {
+		_numSkippedUpdates++;
+		return;
+	}
+	_numUpdates++;
+
 	_headFrame = newHeadFrame;
+	_computedIod = _iod;
+	_computedNearClip = _nearClip;
+	_computedFarClip = _farClip;
+	_matricesValid = true;
 
 	// 1. Get the center of the camera (the eye) position from the head position
 	glm::dmat4 head2Room = _headFrame;
@@ -143,6 +170,59 @@ void CameraOffAxis::updateHeadTrackingFrame(glm::dmat4 newHeadFrame)
 	_view = r2t;//.inverse();
 	_viewLeft = r2tLeft;//.inverse();
 	_viewRight = r2tRight;//.inverse();
+
+	updateFloatMatrices();
+}
+
+void CameraOffAxis::updateFloatMatrices()
+{
+	_projectionf[EYE_CENTER] = glm::mat4(_projection);
+	_projectionf[EYE_LEFT] = glm::mat4(_projectionLeft);
+	_projectionf[EYE_RIGHT] = glm::mat4(_projectionRight);
+	_viewf[EYE_CENTER] = glm::mat4(_view);
+	_viewf[EYE_LEFT] = glm::mat4(_viewLeft);
+	_viewf[EYE_RIGHT] = glm::mat4(_viewRight);
+	if (_projectionOffsetEnabled) {
+		updateOffsetProjections();
+	}
+
+	for (int i = 0; i <= NUM_EYES; i++) {
+		_frustumValid[i] = false;
+	}
+}
+
+void CameraOffAxis::setInterOcularDistance(double interOcularDistance)
+{
+	_iod = interOcularDistance;
+	updateHeadTrackingFrame(_headFrame);
+}
+
+void CameraOffAxis::setClipPlanes(double nearClipDist, double farClipDist)
+{
+	_nearClip = nearClipDist;
+	_farClip = farClipDist;
+	updateHeadTrackingFrame(_headFrame);
+}
+
+void CameraOffAxis::setSinglePrecision(bool singlePrecision)
+{
+	_singlePrecision = singlePrecision;
+	_object2Worldf = glm::mat4(_object2World);
+}
+
+bool CameraOffAxis::isSinglePrecision() const
+{
+	return _singlePrecision;
+}
+
+unsigned long CameraOffAxis::getNumUpdates()
+{
+	return _numUpdates;
+}
+
+unsigned long CameraOffAxis::getNumSkippedUpdates()
+{
+	return _numSkippedUpdates;
 }
 
 glm::dmat4 CameraOffAxis::invertYMat()
@@ -192,33 +272,98 @@ glm::dmat4 CameraOffAxis::getRightEyeFrame()
 	return _headFrame * glm::column(glm::dmat4(1.0), 3, glm::dvec4(_iod/2.0, 0.0, 0.0, 1.0));
 }
 
+void CameraOffAxis::setProjectionOffset(const glm::dvec2& scale, const glm::dvec2& offset)
+{
+	bool enabled = scale != glm::dvec2(1.0) || offset != glm::dvec2(0.0);
+	glm::dmat4 projectionOffset(scale.x, 0, 0, 0,
+								0, scale.y, 0, 0,
+								0, 0, 1, 0,
+								offset.x, offset.y, 0, 1);
+	// The render thread sets the offset for every viewport and eye, usually to the same value
+	if (enabled == _projectionOffsetEnabled && projectionOffset == _projectionOffset) {
+		return;
+	}
+	_projectionOffsetEnabled = enabled;
+	_projectionOffset = projectionOffset;
+	if (_projectionOffsetEnabled) {
+		updateOffsetProjections();
+	}
+	for (int i = 0; i <= NUM_EYES; i++) {
+		_frustumValid[i] = false;
+	}
+}
+
+void CameraOffAxis::updateOffsetProjections()
+{
+	_offsetProjections[EYE_CENTER] = _projectionOffset * _projection;
+	_offsetProjections[EYE_LEFT] = _projectionOffset * _projectionLeft;
+	_offsetProjections[EYE_RIGHT] = _projectionOffset * _projectionRight;
+	for (int i = 0; i < NUM_EYES; i++) {
+		_offsetProjectionf[i] = glm::mat4(_offsetProjections[i]);
+	}
+}
+
+void CameraOffAxis::applyEye(int eye, const glm::dmat4& projectionMat, const glm::dmat4& viewMat)
+{
+	// Tells applyProjectionAndCameraMatrices which eye it is given, subclasses may override it
+	_applyingEye = eye;
+	if (_projectionOffsetEnabled) {
+		applyProjectionAndCameraMatrices(_offsetProjections[eye], viewMat);
+	}
+	else {
+		applyProjectionAndCameraMatrices(projectionMat, viewMat);
+	}
+	_applyingEye = -1;
+}
+
+const glm::mat4& CameraOffAxis::getCurrentProjectionf() const
+{
+	return _currentProjectionOffset ? _offsetProjectionf[_currentEye] : _projectionf[_currentEye];
+}
+
 void CameraOffAxis::applyProjectionAndCameraMatrices()
 {
-	applyProjectionAndCameraMatrices(_projection, _view);
+	applyEye(EYE_CENTER, _projection, _view);
 }
 
 void CameraOffAxis::applyProjectionAndCameraMatricesForLeftEye()
 {
-	applyProjectionAndCameraMatrices(_projectionLeft, _viewLeft);
+	applyEye(EYE_LEFT, _projectionLeft, _viewLeft);
 }
 
 void CameraOffAxis::applyProjectionAndCameraMatricesForRightEye()
 {
-	applyProjectionAndCameraMatrices(_projectionRight, _viewRight);
+	applyEye(EYE_RIGHT, _projectionRight, _viewRight);
+}
+
+void CameraOffAxis::loadModelViewMatrix()
+{
+	if (_currentEye < 0) {
+		// The applied matrices aren't the camera's own, so there is no cached copy
+		glLoadMatrixf(glm::value_ptr(glm::mat4(_currentViewMatrix * _object2World)));
+	}
+	else if (_object2WorldIsIdentity) {
+		glLoadMatrixf(glm::value_ptr(_viewf[_currentEye]));
+	}
+	else if (_singlePrecision) {
+		glLoadMatrixf(glm::value_ptr(_viewf[_currentEye] * _object2Worldf));
+	}
+	else {
+		glLoadMatrixf(glm::value_ptr(glm::mat4(_currentViewMatrix * _object2World)));
+	}
 }
 
 void CameraOffAxis::setObjectToWorldMatrix(glm::dmat4 obj2World)
 {
 	_object2World = obj2World;
-	glMatrixMode(GL_MODELVIEW);
-	glm::dmat4 modelView = _currentViewMatrix * _object2World;
-	GLfloat matrix[16];
-    for (int c = 0; c < 4; ++c) {
-		for(int r = 0; r < 4; ++r) {
-			matrix[c*4+r] = (float)modelView[c][r];
-		}
-    }
-	glLoadMatrixf(matrix);
+	_object2WorldIsIdentity = obj2World == glm::dmat4(1.0);
+	if (_singlePrecision) {
+		_object2Worldf = glm::mat4(obj2World);
+	}
+	if (!_isCoreProfile) {
+		glMatrixMode(GL_MODELVIEW);
+		loadModelViewMatrix();
+	}
 }
 
 glm::dmat4 CameraOffAxis::getObjectToWorldMatrix()
@@ -229,27 +374,23 @@ glm::dmat4 CameraOffAxis::getObjectToWorldMatrix()
 
 void CameraOffAxis::applyProjectionAndCameraMatrices(const glm::dmat4& projectionMat, const glm::dmat4& viewMat)
 {
+	// The camera's own matrices have cached single precision copies, other matrices are converted
+	_currentEye = _applyingEye;
+	_currentProjectionOffset = _currentEye >= 0 && _projectionOffsetEnabled;
 	_currentViewMatrix = viewMat;
 	_currentProjMatrix = projectionMat;
 	if (!_isCoreProfile)
 	{
 		glMatrixMode(GL_PROJECTION);
-		GLfloat matrix[16];
-		for (int c = 0; c < 4; ++c) {
-			for(int r = 0; r < 4; ++r) {
-				matrix[c*4+r] = (float)projectionMat[c][r];
-			}
+		if (_currentEye >= 0) {
+			glLoadMatrixf(glm::value_ptr(getCurrentProjectionf()));
+		}
+		else {
+			glLoadMatrixf(glm::value_ptr(glm::mat4(projectionMat)));
 		}
-		glLoadMatrixf(matrix);
 
 		glMatrixMode(GL_MODELVIEW);
-		glm::dmat4 modelView = viewMat * _object2World;
-		for (int c = 0; c < 4; ++c) {
-			for(int r = 0; r < 4; ++r) {
-				matrix[c*4+r] = (float)modelView[c][r];
-			}
-		}
-		glLoadMatrixf(matrix);
+		loadModelViewMatrix();
 	}
 }
 
@@ -268,6 +409,74 @@ glm::dmat4 CameraOffAxis::getLastAppliedViewMatrix()
 	return _currentViewMatrix;
 }
 
+void CameraOffAxis::getUniformBlock(CameraUniformBlock& block) const
+{
+	glm::dvec4 eyePosition;
+	if (_currentEye >= 0) {
+		memcpy(block.projection, glm::value_ptr(getCurrentProjectionf()), sizeof(block.projection));
+		memcpy(block.view, glm::value_ptr(_viewf[_currentEye]), sizeof(block.view));
+		double eyeOffset = _currentEye == EYE_LEFT ? -_computedIod/2.0 : (_currentEye == EYE_RIGHT ? _computedIod/2.0 : 0.0);
+		eyePosition = _headFrame * glm::dvec4(eyeOffset, 0.0, 0.0, 1.0);
+	}
+	else {
+		memcpy(block.projection, glm::value_ptr(glm::mat4(_currentProjMatrix)), sizeof(block.projection));
+		memcpy(block.view, glm::value_ptr(glm::mat4(_currentViewMatrix)), sizeof(block.view));
+		eyePosition = glm::column(glm::inverse(_currentViewMatrix), 3);
+	}
+	block.eyePosition[0] = (float)eyePosition.x;
+	block.eyePosition[1] = (float)eyePosition.y;
+	block.eyePosition[2] = (float)eyePosition.z;
+	block.eyePosition[3] = 1.0f;
+}
+
+const Frustum& CameraOffAxis::getFrustum(int eye)
+{
+	if (!_frustumValid[eye]) {
+		if (eye == EYE_CENTER) {
+			_frustums[eye] = Frustum(_projection * _view);
+		}
+		else if (eye == EYE_LEFT) {
+			_frustums[eye] = Frustum(_projectionLeft * _viewLeft);
+		}
+		else if (eye == EYE_RIGHT) {
+			_frustums[eye] = Frustum(_projectionRight * _viewRight);
+		}
+		else {
+			_frustums[eye] = Frustum::combine(_projectionLeft * _viewLeft, _projectionRight * _viewRight);
+		}
+		_frustumValid[eye] = true;
+	}
+	return _frustums[eye];
+}
+
+const Frustum& CameraOffAxis::getFrustum()
+{
+	return getFrustum(EYE_CENTER);
+}
+
+const Frustum& CameraOffAxis::getLeftEyeFrustum()
+{
+	return getFrustum(EYE_LEFT);
+}
+
+const Frustum& CameraOffAxis::getRightEyeFrustum()
+{
+	return getFrustum(EYE_RIGHT);
+}
+
+const Frustum& CameraOffAxis::getStereoFrustum()
+{
+	return getFrustum(NUM_EYES);
+}
+
+Frustum CameraOffAxis::getCurrentFrustum()
+{
+	if (_currentEye >= 0 && !_currentProjectionOffset) {
+		return getFrustum(_currentEye);
+	}
+	return Frustum(_currentProjMatrix * _currentViewMatrix);
+}
+
 glm::dvec3 CameraOffAxis::getLookVector()
 {
 	glm::dvec3 right = _topRight-_topLeft;
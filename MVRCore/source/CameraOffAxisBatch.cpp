@@ -0,0 +1,324 @@
+/*
+ * Copyright Regents of the University of Minnesota, 2015.  This software is released under the following license: http://opensource.org/licenses/GPL-2.0
+ * Source code originally developed at the University of Minnesota Interactive Visualization Lab (http://ivlab.cs.umn.edu).
+ *
+ * Code author(s):
+ * 		MinVR Development Team
+ */
+
+#include "MVRCore/CameraOffAxisBatch.H"
+#include <typeinfo>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINVR_CAMERA_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace MinVR {
+
+namespace {
+
+// One camera per lane
+struct Double1 {
+	static const int width = 1;
+	double v;
+	Double1() {}
+	explicit Double1(double x) : v(x) {}
+	static Double1 load(const double* p) { return Double1(*p); }
+	void store(double* p) const { *p = v; }
+};
+inline Double1 operator+(Double1 a, Double1 b) { return Double1(a.v + b.v); }
+inline Double1 operator-(Double1 a, Double1 b) { return Double1(a.v - b.v); }
+inline Double1 operator*(Double1 a, Double1 b) { return Double1(a.v * b.v); }
+inline Double1 operator/(Double1 a, Double1 b) { return Double1(a.v / b.v); }
+inline Double1 operator-(Double1 a) { return Double1(-a.v); }
+
+#ifdef MINVR_CAMERA_BATCH_SSE2
+// Two cameras per lane
+struct Double2 {
+	static const int width = 2;
+	__m128d v;
+	Double2() {}
+	explicit Double2(double x) : v(_mm_set1_pd(x)) {}
+	explicit Double2(__m128d x) : v(x) {}
+	static Double2 load(const double* p) { return Double2(_mm_loadu_pd(p)); }
+	void store(double* p) const { _mm_storeu_pd(p, v); }
+};
+inline Double2 operator+(Double2 a, Double2 b) { return Double2(_mm_add_pd(a.v, b.v)); }
+inline Double2 operator-(Double2 a, Double2 b) { return Double2(_mm_sub_pd(a.v, b.v)); }
+inline Double2 operator*(Double2 a, Double2 b) { return Double2(_mm_mul_pd(a.v, b.v)); }
+inline Double2 operator/(Double2 a, Double2 b) { return Double2(_mm_div_pd(a.v, b.v)); }
+inline Double2 operator-(Double2 a) { return Double2(_mm_xor_pd(a.v, _mm_set1_pd(-0.0))); }
+typedef Double2 DoubleLanes;
+#else
+typedef Double1 DoubleLanes;
+#endif
+
+// One camera per lane in single precision.  The inputs and outputs stay double, they are
+// converted on load and store.
+struct Float1 {
+	static const int width = 1;
+	float v;
+	Float1() {}
+	explicit Float1(double x) : v((float)x) {}
+	explicit Float1(float x) : v(x) {}
+	static Float1 load(const double* p) { return Float1(*p); }
+	void store(double* p) const { *p = v; }
+};
+inline Float1 operator+(Float1 a, Float1 b) { return Float1(a.v + b.v); }
+inline Float1 operator-(Float1 a, Float1 b) { return Float1(a.v - b.v); }
+inline Float1 operator*(Float1 a, Float1 b) { return Float1(a.v * b.v); }
+inline Float1 operator/(Float1 a, Float1 b) { return Float1(a.v / b.v); }
+inline Float1 operator-(Float1 a) { return Float1(-a.v); }
+
+#ifdef MINVR_CAMERA_BATCH_SSE2
+// Four cameras per lane in single precision
+struct Float4 {
+	static const int width = 4;
+	__m128 v;
+	Float4() {}
+	explicit Float4(double x) : v(_mm_set1_ps((float)x)) {}
+	explicit Float4(__m128 x) : v(x) {}
+	static Float4 load(const double* p) { return Float4(_mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p)), _mm_cvtpd_ps(_mm_loadu_pd(p + 2)))); }
+	void store(double* p) const
+	{
+		_mm_storeu_pd(p, _mm_cvtps_pd(v));
+		_mm_storeu_pd(p + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+	}
+};
+inline Float4 operator+(Float4 a, Float4 b) { return Float4(_mm_add_ps(a.v, b.v)); }
+inline Float4 operator-(Float4 a, Float4 b) { return Float4(_mm_sub_ps(a.v, b.v)); }
+inline Float4 operator*(Float4 a, Float4 b) { return Float4(_mm_mul_ps(a.v, b.v)); }
+inline Float4 operator/(Float4 a, Float4 b) { return Float4(_mm_div_ps(a.v, b.v)); }
+inline Float4 operator-(Float4 a) { return Float4(_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))); }
+typedef Float4 FloatLanes;
+#else
+typedef Float1 FloatLanes;
+#endif
+
+// The lane widths are powers of two, so padding to the wider one suits both
+const size_t batchWidth = FloatLanes::width > DoubleLanes::width ? FloatLanes::width : DoubleLanes::width;
+
+// The closed form of CameraOffAxis::updateHeadTrackingFrame for one eye.  The
+// multiplications by invertYMat() and by the eye translation only flip signs
+// and add a translation, so they are folded in here.  With double lanes the
+// results are bit identical to CameraOffAxis, including the sign of zeros, so
+// the products with zero that glm's matrix multiplication adds are kept where
+// they can change that sign.
+template<class V>
+void computeEye(size_t begin, size_t end, const glm::dmat4& headFrame, bool centerEye,
+	const std::vector<double> (&room2tile)[16], const std::vector<double>& halfWidth, const std::vector<double>& halfHeight,
+	const std::vector<double>& nearClip, const std::vector<double>& eyeOffset,
+	std::vector<double> (&projection)[4], std::vector<double> (&view)[12])
+{
+	V head0[4], head1[4], head2[4], head3[4];
+	for (int c = 0; c < 4; c++) {
+		head0[c] = V(headFrame[0][c]);
+		head1[c] = V(headFrame[1][c]);
+		head2[c] = V(headFrame[2][c]);
+		head3[c] = V(headFrame[3][c]);
+	}
+	const V zero(0.0);
+	const V two(2.0);
+
+	for (size_t i = begin; i < end; i += V::width) {
+		V r[16];
+		for (int k = 0; k < 16; k++) {
+			r[k] = V::load(&room2tile[k][i]);
+		}
+
+		// The eye in room coordinates is the last column of headFrame * translate(eyeOffset, 0, 0),
+		// the center eye is the head itself
+		V s = V::load(&eyeOffset[i]);
+		V eyeRoom[4];
+		for (int c = 0; c < 4; c++) {
+			eyeRoom[c] = centerEye ? head3[c] : ((head0[c] * s + head1[c] * zero) + head2[c] * zero) + head3[c];
+		}
+
+		// and in tile coordinates, room2tile * eyeRoom
+		V eye[3];
+		for (int c = 0; c < 3; c++) {
+			eye[c] = ((r[c] * eyeRoom[0] + r[4+c] * eyeRoom[1]) + r[8+c] * eyeRoom[2]) + r[12+c] * eyeRoom[3];
+		}
+
+		V halfW = V::load(&halfWidth[i]);
+		V halfH = V::load(&halfHeight[i]);
+		V nearVal = V::load(&nearClip[i]);
+		V k = nearVal / eye[2];
+		V left = (-halfW - eye[0]) * k;
+		V right = (halfW - eye[0]) * k;
+		V bottom = (-halfH - eye[1]) * k;
+		V top = (halfH - eye[1]) * k;
+
+		V twoNear = two * nearVal;
+		(twoNear / (right - left)).store(&projection[0][i]);
+		(twoNear / (top - bottom)).store(&projection[1][i]);
+		((right + left) / (right - left)).store(&projection[2][i]);
+		((top + bottom) / (top - bottom)).store(&projection[3][i]);
+
+		// translate(-eye) * room2tile
+		for (int j = 0; j < 4; j++) {
+			((r[j*4] + zero * r[j*4+1]) + zero * r[j*4+2] - eye[0] * r[j*4+3]).store(&view[j*3][i]);
+			((zero * r[j*4] + r[j*4+1]) + zero * r[j*4+2] - eye[1] * r[j*4+3]).store(&view[j*3+1][i]);
+			((zero * r[j*4] + zero * r[j*4+1]) + r[j*4+2] - eye[2] * r[j*4+3]).store(&view[j*3+2][i]);
+		}
+	}
+}
+
+}
+
+CameraOffAxisBatch::CameraOffAxisBatch() : _paddedSize(0), _singlePrecision(false)
+{
+}
+
+CameraOffAxisBatch::~CameraOffAxisBatch()
+{
+}
+
+void CameraOffAxisBatch::setSinglePrecision(bool singlePrecision)
+{
+	_singlePrecision = singlePrecision;
+}
+
+bool CameraOffAxisBatch::isSinglePrecision() const
+{
+	return _singlePrecision;
+}
+
+bool CameraOffAxisBatch::canBatch(const std::vector<AbstractCameraRef>& cameras)
+{
+	for (int i = 0; i < cameras.size(); i++) {
+		// Subclasses may change how the matrices are calculated
+		if (cameras[i] == nullptr || typeid(*cameras[i]) != typeid(CameraOffAxis)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void CameraOffAxisBatch::setCameras(const std::vector<AbstractCameraRef>& cameras)
+{
+	_cameras.resize(cameras.size());
+	for (int i = 0; i < cameras.size(); i++) {
+		_cameras[i] = static_cast<CameraOffAxis*>(cameras[i].get());
+	}
+
+	// Pad to a whole number of lanes by repeating the last camera
+	_paddedSize = (cameras.size() + batchWidth - 1) / batchWidth * batchWidth;
+	for (int k = 0; k < 16; k++) {
+		_room2tile[k].resize(_paddedSize);
+	}
+	_halfWidth.resize(_paddedSize);
+	_halfHeight.resize(_paddedSize);
+	_nearClip.resize(_paddedSize);
+	for (int e = 0; e < NUM_EYES; e++) {
+		_eyeOffset[e].resize(_paddedSize);
+		for (int k = 0; k < 4; k++) {
+			_projection[e][k].resize(_paddedSize);
+		}
+		for (int k = 0; k < 12; k++) {
+			_view[e][k].resize(_paddedSize);
+		}
+	}
+
+	for (size_t i = 0; i < _paddedSize; i++) {
+		CameraOffAxis* camera = _cameras[i < _cameras.size() ? i : _cameras.size() - 1];
+		for (int k = 0; k < 16; k++) {
+			_room2tile[k][i] = camera->_room2tile[k/4][k%4];
+		}
+		_halfWidth[i] = camera->_halfWidth;
+		_halfHeight[i] = camera->_halfHeight;
+	}
+}
+
+void CameraOffAxisBatch::updateHeadTrackingFrame(const std::vector<AbstractCameraRef>& cameras, const glm::dmat4& headFrame)
+{
+	if (cameras.empty()) {
+		return;
+	}
+
+	bool changed = cameras.size() != _cameras.size();
+	for (int i = 0; !changed && i < cameras.size(); i++) {
+		changed = cameras[i].get() != _cameras[i];
+	}
+	if (changed) {
+		setCameras(cameras);
+	}
+
+	bool anyNeedsUpdate = false;
+	for (int i = 0; i < _cameras.size(); i++) {
+		anyNeedsUpdate = anyNeedsUpdate || _cameras[i]->needsUpdate(headFrame);
+	}
+	if (!anyNeedsUpdate) {
+		CameraOffAxis::_numSkippedUpdates += _cameras.size();
+		return;
+	}
+
+	// The interocular distance and clip planes can change at any time
+	for (size_t i = 0; i < _paddedSize; i++) {
+		CameraOffAxis* camera = _cameras[i < _cameras.size() ? i : _cameras.size() - 1];
+		_nearClip[i] = camera->_nearClip;
+		_eyeOffset[EYE_CENTER][i] = 0.0;
+		_eyeOffset[EYE_LEFT][i] = -camera->_iod/2.0;
+		_eyeOffset[EYE_RIGHT][i] = camera->_iod/2.0;
+	}
+
+	for (int e = 0; e < NUM_EYES; e++) {
+		if (_singlePrecision) {
+			computeEye<FloatLanes>(0, _paddedSize, headFrame, e == EYE_CENTER, _room2tile, _halfWidth, _halfHeight, _nearClip, _eyeOffset[e], _projection[e], _view[e]);
+		}
+		else {
+			computeEye<DoubleLanes>(0, _paddedSize, headFrame, e == EYE_CENTER, _room2tile, _halfWidth, _halfHeight, _nearClip, _eyeOffset[e], _projection[e], _view[e]);
+		}
+	}
+
+	for (int i = 0; i < _cameras.size(); i++) {
+		CameraOffAxis* camera = _cameras[i];
+		if (!camera->needsUpdate(headFrame)) {
+			CameraOffAxis::_numSkippedUpdates++;
+			continue;
+		}
+		CameraOffAxis::_numUpdates++;
+
+		double nearVal = camera->_nearClip;
+		double farVal = camera->_farClip;
+		double c, d;
+		if (farVal >= std::numeric_limits<double>::max()) {
+			c = -1.0;
+			d = -2.0 * nearVal;
+		} else {
+			c = -(farVal+nearVal) / (farVal-nearVal);
+			d = -(2.0*farVal*nearVal) / (farVal-nearVal);
+		}
+
+		// The bottom row of the views doesn't depend on the eye, it is row 3 of translate(-eye) * room2tile
+		double viewRow3[4];
+		for (int j = 0; j < 4; j++) {
+			const glm::dvec4& room2tile = camera->_room2tile[j];
+			viewRow3[j] = ((0.0 * room2tile[0] + 0.0 * room2tile[1]) + 0.0 * room2tile[2]) + room2tile[3];
+		}
+
+		glm::dmat4* projections[NUM_EYES] = { &camera->_projection, &camera->_projectionLeft, &camera->_projectionRight };
+		glm::dmat4* views[NUM_EYES] = { &camera->_view, &camera->_viewLeft, &camera->_viewRight };
+		for (int e = 0; e < NUM_EYES; e++) {
+			*projections[e] = glm::dmat4(_projection[e][0][i], 0, 0, 0,
+										0, _projection[e][1][i], 0, 0,
+										_projection[e][2][i], _projection[e][3][i], c, -1,
+										0, 0, d, 0);
+			glm::dmat4& view = *views[e];
+			for (int j = 0; j < 4; j++) {
+				view[j] = glm::dvec4(_view[e][j*3][i], _view[e][j*3+1][i], _view[e][j*3+2][i], viewRow3[j]);
+			}
+		}
+
+		camera->_headFrame = headFrame;
+		camera->_computedIod = camera->_iod;
+		camera->_computedNearClip = camera->_nearClip;
+		camera->_computedFarClip = camera->_farClip;
+		camera->_matricesValid = true;
+		camera->updateFloatMatrices();
+	}
+}
+
+} // end namespace
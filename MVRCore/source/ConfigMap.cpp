@@ -59,19 +59,15 @@ bool ConfigMap::readFile(const std::string &filename)
 
 	if (MinVR::FileSystem::getInstance().exists(filename))
 	{
-		std::string output = "ConfigMap parsing file \"" + filename + "\".";
-		Logger::getInstance().log(output, "tag", "MVRCore");
+		MINVR_LOG_INFO("MVRCore", "ConfigMap parsing file \"" << filename << "\".");
 
-		ifstream fIn;
-		fIn.open(filename.c_str(),std::ios::in);
-
-		if (!fIn) {
+		MappedFileRef file = MinVR::FileSystem::getInstance().mapFile(filename);
+		if (file == nullptr) {
 			MinVR::Logger::getInstance().assertMessage(false, "ConfigMap Error: Unable to load config file");
 		}
-		std::stringstream ss;
-		ss << fIn.rdbuf();
-    
-		instr =  ss.str();
+		else {
+			instr.assign(file->getData(), file->getSize());
+		}
 	}
 	else
 	{  
@@ -100,6 +96,12 @@ bool ConfigMap::readFile(const std::string &filename)
 	// add a \n so that every file ends in at least one \n
 	instr = instr + std::string("\n");
 
+	// all of the pairs in the file are applied to a private copy of the
+	// current snapshot and published together once the file is parsed, so
+	// readers never see a half-loaded file
+	UniqueMutexLock lock(_writeMutex);
+	std::shared_ptr<Table> table(new Table(*getSnapshot()));
+
 	// start pulling out name, value pairs
 	// the config file must end with a newline
 	//
@@ -177,16 +179,16 @@ bool ConfigMap::readFile(const std::string &filename)
 				{
 					name = name.substr(0,name.size()-2);
 
-					if (ConfigMap::containsKey(name)) {
-						std::string newVal = ConfigMap::getValue(name) + " " + val;
-						ConfigMap::set(name, newVal);
+					Table::iterator it = table->find(name);
+					if (it != table->end()) {
+						it->second = it->second + " " + val;
 					}
 					else {
-						ConfigMap::set(name, val);
+						(*table)[name] = val;
 					}
 				}
 				else {
-					ConfigMap::set(name, val);
+					(*table)[name] = val;
 				}
 			}
 		} // end not a comment
@@ -194,49 +196,63 @@ bool ConfigMap::readFile(const std::string &filename)
 		instr = instr.substr(endline+1);
 	}
 
+	publish(table);
 	return true;
 }
 
 void ConfigMap::debugPrint()
 {
-	std::vector<std::string> keys;
-	for(std::unordered_map<std::string, std::string>::iterator it = _map.begin(); it != _map.end(); ++it) {
-		keys.push_back(it->first);
+	Snapshot snapshot = getSnapshot();
+	for(Table::const_iterator it = snapshot->begin(); it != snapshot->end(); ++it) {
+		std::cout << "\"" << it->first << "\"" << " --> " 
+			<< "\"" << it->second << "\"" << std::endl;
 	}
+}
 
-	for (int i=0;i<keys.size();i++) {
-		std::cout << "\"" << keys[i] << "\"" << " --> " 
-			<< "\"" << _map[keys[i]] << "\"" << std::endl;
-	}
+ConfigMap::Snapshot ConfigMap::getSnapshot() const
+{
+	return std::atomic_load(&_snapshot);
 }
 
-bool ConfigMap::containsKey(const std::string &keyString)
+void ConfigMap::publish(const Snapshot &snapshot)
 {
-	if (_map.find(keyString) != _map.end()) {
-		return true;
+	std::atomic_store(&_snapshot, snapshot);
+}
+
+bool ConfigMap::lookup(const std::string &keyString, std::string &value) const
+{
+	Snapshot snapshot = getSnapshot();
+	Table::const_iterator it = snapshot->find(keyString);
+	if (it == snapshot->end()) {
+		return false;
 	}
-	return false;
+	value = it->second;
+	return true;
+}
+
+bool ConfigMap::containsKey(const std::string &keyString) const
+{
+	Snapshot snapshot = getSnapshot();
+	return snapshot->find(keyString) != snapshot->end();
 }
 
-std::string ConfigMap::getValue(const std::string &keyString)
+std::string ConfigMap::getValue(const std::string &keyString) const
 {
-	return _map[keyString];
+	std::string value;
+	lookup(keyString, value);
+	return value;
 }
 
 void ConfigMap::set(const std::string &key, const std::string &value)
 {
-	std::unordered_map<std::string,std::string>::iterator got = _map.find (key);
-	if ( got == _map.end() ) {
-		// If not found insert it
-		_map.insert(std::pair<std::string, std::string>(key, value));
-	}
-	else {
-		// change existing value
-		got->second = value;
-	}
+	// copy-on-write: readers holding the previous snapshot are unaffected
+	UniqueMutexLock lock(_writeMutex);
+	std::shared_ptr<Table> table(new Table(*getSnapshot()));
+	(*table)[key] = value;
+	publish(table);
 }
 
-ConfigMap::ConfigMap(int argc, char **argv, bool exitOnUnrecognizedArgument)
+ConfigMap::ConfigMap(int argc, char **argv, bool exitOnUnrecognizedArgument) : _snapshot(new Table())
 {
 	// put args into std::strings so they are easier to manipulate
 	std::vector<std::string> args;
@@ -46,11 +46,29 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "MVRCore/DataFileUtils.H"
 #include "io/FileSystem.h"
+#include "log/LogRateLimiter.h"
+#include <algorithm>
+#include <cctype>
 
 namespace MinVR
 {
 
 static DataFileUtils* common = nullptr;
+static Mutex commonMutex;
+
+// Windows and OS X file systems are case insensitive by default, so names are
+// folded before indexing.  Folding on a case sensitive volume only costs an
+// extra existence check, never a missed file.
+static std::string indexKey(const std::string &name)
+{
+#if defined(WIN32) || defined(__APPLE__)
+	std::string key = name;
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	return key;
+#else
+	return name;
+#endif
+}
 
 DataFileUtils& DataFileUtils::instance()
 {
@@ -60,6 +78,7 @@ DataFileUtils& DataFileUtils::instance()
 
 void DataFileUtils::init()
 {
+	UniqueMutexLock lock(commonMutex);
 	if (common == nullptr)
 	{
 		common = new DataFileUtils();
@@ -68,6 +87,7 @@ void DataFileUtils::init()
 
 void DataFileUtils::cleanup()
 {
+	UniqueMutexLock lock(commonMutex);
     if (common != nullptr) {
         delete common;
         common = nullptr;
@@ -84,7 +104,22 @@ void DataFileUtils::addFileSearchPath(const std::string &path)
 	instance()._addFileSearchPath(path);
 }
 
-DataFileUtils::DataFileUtils()
+void DataFileUtils::invalidateCache()
+{
+	DataFileUtils& utils = instance();
+	UniqueMutexLock lock(utils._mutex);
+	utils._resolvedFiles.clear();
+	utils._directoryIndex.clear();
+}
+
+int DataFileUtils::getNumFileSystemProbes()
+{
+	DataFileUtils& utils = instance();
+	UniqueMutexLock lock(utils._mutex);
+	return utils._numProbes;
+}
+
+DataFileUtils::DataFileUtils() : _numProbes(0)
 {
 	_dataFilePaths.push_back(".");
 	_dataFilePaths.push_back("share");
@@ -112,29 +147,87 @@ DataFileUtils::DataFileUtils()
 	}
 }
 
-std::string DataFileUtils::_findDataFile(const std::string &filename)
+bool DataFileUtils::_mightContain(const std::string &dir, const std::string &filename)
+{
+	size_t end = filename.find_first_of("/\\");
+	std::string first = filename.substr(0, end);
+	if (first.empty() || first == "." || first == "..") {
+		// Absolute or relative to the parent, the listing of dir says nothing about it
+		return true;
+	}
+
+	std::unordered_map<std::string, std::unordered_set<std::string> >::iterator it = _directoryIndex.find(dir);
+	if (it == _directoryIndex.end()) {
+		// One listing per search path replaces an existence check per file.
+		// Missing directories list as empty and are never probed again.
+		std::unordered_set<std::string> &entries = _directoryIndex[dir];
+		// Listing with directories set returns both files and subdirectories
+		std::vector<std::string> names = FileSystem::getInstance().listDirectory(dir, true);
+		_numProbes++;
+		for (int f = 0; f < names.size(); f++) {
+			entries.insert(indexKey(names[f]));
+		}
+		it = _directoryIndex.find(dir);
+	}
+
+	return it->second.find(indexKey(first)) != it->second.end();
+}
+
+std::string DataFileUtils::_searchDataFilePaths(const std::string &filename)
 {
 	for (int i = 0; i < _dataFilePaths.size(); i++)	{ 
+		if (!_mightContain(_dataFilePaths[i], filename)) {
+			continue;
+		}
 		std::string fname = FileSystem::getInstance().concatPath(_dataFilePaths[i], filename);
+		_numProbes++;
 		if (FileSystem::getInstance().exists(fname)) {
 			return fname;
 		}
 	}
+	return "";
+}
 
-	std::cout << "Could not find data file as either:" << std::endl;
+std::string DataFileUtils::_findDataFile(const std::string &filename)
+{
+	UniqueMutexLock lock(_mutex);
 
+	std::unordered_map<std::string, std::string>::iterator cached = _resolvedFiles.find(filename);
+	if (cached != _resolvedFiles.end()) {
+		return cached->second;
+	}
+
+	bool freshListings = _directoryIndex.empty();
+	std::string fname = _searchDataFilePaths(filename);
+	if (fname == "" && !freshListings) {
+		// The file may have been created since the directories were listed
+		_directoryIndex.clear();
+		fname = _searchDataFilePaths(filename);
+	}
+	if (fname != "") {
+		_resolvedFiles[filename] = fname;
+		return fname;
+	}
+
+	// Misses are not cached, so a file created later is still found
+	std::stringstream candidates;
 	for (int i = 0; i < _dataFilePaths.size(); i++) {  
-		std::string fname = FileSystem::getInstance().concatPath(_dataFilePaths[i], filename);
-		std::cout << i << ". " << fname << std::endl;
+		candidates << std::endl << i << ". " << FileSystem::getInstance().concatPath(_dataFilePaths[i], filename);
 	}
+	MINVR_LOG_RATE_LIMITED(LOGLEVEL_WARNING, "MVRCore", "Could not find data file as either:" << candidates.str());
 
 	return "";
 }
 
 void DataFileUtils::_addFileSearchPath(const std::string &path)
 {
+	UniqueMutexLock lock(_mutex);
+
 	// Add to the front so that user added paths get searched first
 	_dataFilePaths.insert(_dataFilePaths.begin(), replaceEnvVars(path));
+
+	// The new path may shadow files that were already resolved
+	_resolvedFiles.clear();
 }
 
 } // end namespace
@@ -49,8 +49,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "MVRCore/AbstractWindow.H"
 #include "log/Logger.h"
+#include <glm/gtc/type_ptr.hpp>
 #include <sstream>
 #include <iomanip>
+#include <string.h>
 
 namespace MinVR {
 	
@@ -67,7 +69,7 @@ Event::Event(const std::string &name, const double data, const WindowRef window/
 { 
 	_timestamp = timestamp;
 	_name = name;
-	_data1D = data;
+	_data[0] = data;
 	_type = EVENTTYPE_1D;
 	_id = id;
 	_window = window;
@@ -77,7 +79,7 @@ Event::Event(const std::string &name, const glm::dvec2 &data, const WindowRef wi
 { 
 	_timestamp = timestamp;
 	_name = name;
-	_data2D = data;
+	setData(glm::value_ptr(data), 2);
 	_type = EVENTTYPE_2D;
 	_id = id;
 	_window = window;
@@ -87,7 +89,7 @@ Event::Event(const std::string &name, const glm::dvec3 &data, const WindowRef wi
 { 
 	_timestamp = timestamp;
 	_name = name;
-	_data3D = data;
+	setData(glm::value_ptr(data), 3);
 	_type = EVENTTYPE_3D;
 	_id = id;
 	_window = window;
@@ -97,7 +99,7 @@ Event::Event(const std::string &name, const glm::dvec4 &data, const WindowRef wi
 {
 	_timestamp = timestamp;
 	_name = name;
-	_data4D = data;
+	setData(glm::value_ptr(data), 4);
 	_type = EVENTTYPE_4D;
 	_id = id;
 	_window = window;
@@ -108,7 +110,7 @@ Event::Event(const std::string &name, const glm::dmat4 &data, const WindowRef wi
 { 
 	_timestamp = timestamp;
 	_name = name;
-	_dataCF = data;
+	setData(glm::value_ptr(data), 16);
 	_type = EVENTTYPE_COORDINATEFRAME;
 	_id = id;
 	_window = window;
@@ -124,24 +126,35 @@ Event::Event(const std::string &name, const std::string &data, const WindowRef w
 	_window = window;
 }
 
-Event::Event(const std::string &eventString, const TimeStamp &timestamp)
+Event::Event(const std::string &name, const RigidPose &data, const WindowRef window/*= nullptr*/, const int id/*= -1*/, const TimeStamp &timestamp)
 {
 	_timestamp = timestamp;
+	_name = name;
+	setRigidPose(data);
+	_type = EVENTTYPE_RIGIDPOSE;
+	_id = id;
+	_window = window;
+}
 
-	std::string str = eventString;
-	MinVR::popNextToken(str, _name, false);
-
-	std::string val, data, id, tmp;
-	int type;
-	MinVR::popNextToken(str, val, false);
-	MinVR::popNextToken(str, tmp, false); // remove (Data: from string
-	str = trimWhitespace(str);
-	MinVR::popUntilSemicolon(str, data); // get data
-	MinVR::popNextToken(str, tmp, false); // remove Id: 
-	MinVR::popNextToken(str, id, false); // get id
+Event::Event(const std::string &eventString, const TimeStamp &timestamp)
+{
+	_timestamp = timestamp;
 
-	retypeString(val, type);
-	retypeString(id, _id);
+	StringTokenizer tokenizer(eventString);
+	StringView name, val, dataView, id, tmp;
+	int type = -1;
+	tokenizer.next(name, false);
+	tokenizer.next(val, false);
+	tokenizer.next(tmp, false); // skip (Data:
+	tokenizer.skipWhitespace();
+	tokenizer.nextUntilSemicolon(dataView); // get data
+	tokenizer.next(tmp, false); // skip Id:
+	tokenizer.next(id, false); // get id
+
+	_name = name.str();
+	std::string data = dataView.str();
+	retypeString(val.str(), type);
+	retypeString(id.str(), _id);
 	
 	switch(type) {
 		case 0:
@@ -149,24 +162,40 @@ Event::Event(const std::string &eventString, const TimeStamp &timestamp)
 			break;
 		case 1:
 			_type = EVENTTYPE_1D;
-			retypeString(data, _data1D);
+			retypeString(data, _data[0]);
 			break;
 		case 2:
+		{
 			_type = EVENTTYPE_2D;
-			retypeString(data, _data2D);
+			glm::dvec2 data2D;
+			retypeString(data, data2D);
+			setData(glm::value_ptr(data2D), 2);
 			break;
+		}
 		case 3:
+		{
 			_type = EVENTTYPE_3D;
-			retypeString(data, _data3D);
+			glm::dvec3 data3D;
+			retypeString(data, data3D);
+			setData(glm::value_ptr(data3D), 3);
 			break;
+		}
 		case 4:
+		{
 			_type = EVENTTYPE_4D;
-			retypeString(data, _data4D);
+			glm::dvec4 data4D;
+			retypeString(data, data4D);
+			setData(glm::value_ptr(data4D), 4);
 			break;
+		}
 		case 5:
+		{
 			_type = EVENTTYPE_COORDINATEFRAME;
-			retypeString(data, _dataCF);
+			glm::dmat4 dataCF;
+			retypeString(data, dataCF);
+			setData(glm::value_ptr(dataCF), 16);
 			break;
+		}
 		case 6:
 			_type = EVENTTYPE_MSG;
 			_dataMsg = data;
@@ -174,6 +203,20 @@ Event::Event(const std::string &eventString, const TimeStamp &timestamp)
 				_dataMsg = "\n";
 			}
 			break;
+		case 7:
+		{
+			// (tx ,ty ,tz) (qw ,qx ,qy ,qz)
+			_type = EVENTTYPE_RIGIDPOSE;
+			size_t split = data.find(')');
+			glm::dvec3 translation;
+			glm::dvec4 rotation(1.0, 0.0, 0.0, 0.0);
+			if (split != std::string::npos) {
+				retypeString(data.substr(0, split + 1), translation);
+				retypeString(data.substr(split + 1), rotation);
+			}
+			setRigidPose(RigidPose(glm::dquat(rotation[0], rotation[1], rotation[2], rotation[3]), translation));
+			break;
+		}
 		default:
 			MinVR::Logger::getInstance().assertMessage(false, "Unknown Event type in Event constructor from event string");
 	}
@@ -185,6 +228,24 @@ Event::~Event()
 {
 }
 
+void Event::setData(const double* data, int size)
+{
+	memcpy(_data, data, size * sizeof(double));
+}
+
+void Event::setRigidPose(const RigidPose& pose)
+{
+	const glm::dvec3& translation = pose.getTranslation();
+	const glm::dquat& rotation = pose.getRotation();
+	_data[0] = translation.x;
+	_data[1] = translation.y;
+	_data[2] = translation.z;
+	_data[3] = rotation.w;
+	_data[4] = rotation.x;
+	_data[5] = rotation.y;
+	_data[6] = rotation.z;
+}
+
 void Event::rename(const std::string &newname)
 {
 	_name = newname;
@@ -212,27 +273,38 @@ WindowRef Event::getWindow() const
 
 double Event::get1DData()
 {
-	return _data1D;
+	return _data[0];
 }
 
 glm::dvec2 Event::get2DData()
 {
-	return _data2D;
+	return glm::make_vec2(_data);
 }
 
 glm::dvec3	Event::get3DData()
 {
-	return _data3D;
+	return glm::make_vec3(_data);
 }
 
 glm::dvec4	Event::get4DData()
 {
-	return _data4D;
+	return glm::make_vec4(_data);
 }
 
 glm::dmat4	Event::getCoordinateFrameData()
 {
-	return _dataCF;
+	if (_type == EVENTTYPE_RIGIDPOSE) {
+		return getRigidPoseData().toDMat4();
+	}
+	return glm::make_mat4(_data);
+}
+
+RigidPose Event::getRigidPoseData()
+{
+	if (_type == EVENTTYPE_COORDINATEFRAME) {
+		return RigidPose(glm::make_mat4(_data));
+	}
+	return RigidPose(glm::dquat(_data[3], _data[4], _data[5], _data[6]), glm::make_vec3(_data));
 }
 
 std::string	Event::getMsgData()
@@ -269,16 +341,16 @@ std::string	Event::toString()
 		ss << _dataMsg;
 		break;
 	case EVENTTYPE_1D:
-		ss << _data1D;
+		ss << _data[0];
 		break;
 	case EVENTTYPE_2D:
-		ss << "(" << _data2D[0] << " ," << _data2D[1] << ")";
+		ss << "(" << _data[0] << " ," << _data[1] << ")";
 		break;
 	case EVENTTYPE_3D:
-		ss << "(" << _data3D[0] << " ," << _data3D[1] << " ," << _data3D[2] << ")";
+		ss << "(" << _data[0] << " ," << _data[1] << " ," << _data[2] << ")";
 		break;
 	case EVENTTYPE_4D:
-		ss << "(" << _data4D[0] << " ," << _data4D[1] << " ," << _data4D[2] << " ," << _data4D[3] << ")";
+		ss << "(" << _data[0] << " ," << _data[1] << " ," << _data[2] << " ," << _data[3] << ")";
 		break;
 	case EVENTTYPE_COORDINATEFRAME:
 		ss << "(";
@@ -290,7 +362,7 @@ std::string	Event::toString()
 			}
 			for (int i = 0; i < 4; i++)
 			{
-				ss << "(" << _dataCF[i][f] << " ," << _dataCF[i][f] << " ," << _dataCF[i][f] << " ," << _dataCF[i][f] << ")";
+				ss << "(" << _data[i * 4 + f] << " ," << _data[i * 4 + f] << " ," << _data[i * 4 + f] << " ," << _data[i * 4 + f] << ")";
 			}
 		}
 		ss << ")";
@@ -298,6 +370,11 @@ std::string	Event::toString()
 	case EVENTTYPE_MSG:
 		ss << escapedMessage;
 		break;
+	case EVENTTYPE_RIGIDPOSE:
+	{
+		ss << "(" << _data[0] << " ," << _data[1] << " ," << _data[2] << ") (" << _data[3] << " ," << _data[4] << " ," << _data[5] << " ," << _data[6] << ")";
+		break;
+	}
 	default:
 		return _name;
 		break;
@@ -333,6 +410,9 @@ EventRef createCopyOfEvent(EventRef e)
 		case Event::EVENTTYPE_MSG:
 			return std::shared_ptr<Event>(new Event(e->getName(),e->getMsgData(), e->getWindow(), e->getId()));
 			break;
+		case Event::EVENTTYPE_RIGIDPOSE:
+			return std::shared_ptr<Event>(new Event(e->getName(),e->getRigidPoseData(), e->getWindow(), e->getId()));
+			break;
 		default:
 			MinVR::Logger::getInstance().assertMessage(false, "createCopyOfEvent: Unknown event type!");
 			return NULL;
@@ -0,0 +1,255 @@
+/*
+ * Copyright Regents of the University of Minnesota, 2015.  This software is released under the following license: http://opensource.org/licenses/GPL-2.0
+ * Source code originally developed at the University of Minnesota Interactive Visualization Lab (http://ivlab.cs.umn.edu).
+ *
+ * Code author(s):
+ * 		MinVR Development Team
+ */
+
+#include "MVRCore/Frustum.H"
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINVR_FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace MinVR {
+
+namespace {
+
+// Row r of a column major matrix
+glm::dvec4 row(const glm::dmat4& m, int r)
+{
+	return glm::dvec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+}
+
+// Gribb and Hartmann: the clip space conditions -w <= x, y, z <= w expressed in the space m transforms from
+void extractPlanes(const glm::dmat4& m, glm::dvec4 planes[Frustum::NUM_PLANES])
+{
+	glm::dvec4 r0 = row(m, 0);
+	glm::dvec4 r1 = row(m, 1);
+	glm::dvec4 r2 = row(m, 2);
+	glm::dvec4 r3 = row(m, 3);
+	planes[Frustum::PLANE_LEFT] = r3 + r0;
+	planes[Frustum::PLANE_RIGHT] = r3 - r0;
+	planes[Frustum::PLANE_BOTTOM] = r3 + r1;
+	planes[Frustum::PLANE_TOP] = r3 - r1;
+	planes[Frustum::PLANE_NEAR] = r3 + r2;
+	planes[Frustum::PLANE_FAR] = r3 - r2;
+}
+
+// Scales the plane so the normal has unit length.  A plane without a normal, like the far
+// plane of an infinite projection, is replaced by one that contains everything.
+glm::dvec4 normalizePlane(const glm::dvec4& plane)
+{
+	double length = glm::length(glm::dvec3(plane.x, plane.y, plane.z));
+	if (length <= 1e-12 * std::abs(plane.w) || length == 0.0) {
+		return glm::dvec4(0.0, 0.0, 0.0, 1.0);
+	}
+	return plane / length;
+}
+
+// The corners of the frustum in homogeneous coordinates with w >= 0.  Corners at infinity have w = 0.
+void getCorners(const glm::dmat4& viewProjection, glm::dvec4 corners[8])
+{
+	glm::dmat4 inverse = glm::inverse(viewProjection);
+	int i = 0;
+	for (int z = -1; z <= 1; z += 2) {
+		for (int y = -1; y <= 1; y += 2) {
+			for (int x = -1; x <= 1; x += 2) {
+				glm::dvec4 corner = inverse * glm::dvec4(x, y, z, 1.0);
+				if (corner.w < 0.0) {
+					corner = -corner;
+				}
+				if (corner.w <= 1e-12 * glm::length(glm::dvec3(corner.x, corner.y, corner.z))) {
+					corner.w = 0.0;
+				}
+				corners[i++] = corner;
+			}
+		}
+	}
+}
+
+// Moves plane out until all points are inside.  Returns false if a point at infinity is outside,
+// in which case no offset of this plane can contain it.
+bool containPoints(glm::dvec4& plane, const glm::dvec4* points, int numPoints)
+{
+	glm::dvec3 normal(plane.x, plane.y, plane.z);
+	for (int i = 0; i < numPoints; i++) {
+		glm::dvec3 p(points[i].x, points[i].y, points[i].z);
+		if (points[i].w == 0.0) {
+			if (glm::dot(normal, p) < -1e-9 * glm::length(p)) {
+				return false;
+			}
+		}
+		else {
+			double d = -glm::dot(normal, p) / points[i].w;
+			if (d > plane.w) {
+				plane.w = d;
+			}
+		}
+	}
+	return true;
+}
+
+} // end anonymous namespace
+
+Frustum::Frustum()
+{
+	for (int i = 0; i < NUM_PLANES; i++) {
+		_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+Frustum::Frustum(const glm::dmat4& viewProjection)
+{
+	glm::dvec4 planes[NUM_PLANES];
+	extractPlanes(viewProjection, planes);
+	for (int i = 0; i < NUM_PLANES; i++) {
+		setPlane(i, normalizePlane(planes[i]));
+	}
+}
+
+Frustum Frustum::combine(const glm::dmat4& viewProjectionA, const glm::dmat4& viewProjectionB)
+{
+	glm::dvec4 planesA[NUM_PLANES];
+	glm::dvec4 planesB[NUM_PLANES];
+	extractPlanes(viewProjectionA, planesA);
+	extractPlanes(viewProjectionB, planesB);
+
+	glm::dvec4 corners[16];
+	getCorners(viewProjectionA, corners);
+	getCorners(viewProjectionB, corners + 8);
+
+	Frustum combined;
+	for (int i = 0; i < NUM_PLANES; i++) {
+		glm::dvec4 candidates[2] = { normalizePlane(planesA[i]), normalizePlane(planesB[i]) };
+		glm::dvec4 best(0.0, 0.0, 0.0, 1.0);
+		double bestGrowth = std::numeric_limits<double>::max();
+		for (int c = 0; c < 2; c++) {
+			glm::dvec4 plane = candidates[c];
+			double originalOffset = plane.w;
+			if (containPoints(plane, corners, 16) && plane.w - originalOffset < bestGrowth) {
+				bestGrowth = plane.w - originalOffset;
+				best = plane;
+			}
+		}
+		combined.setPlane(i, best);
+	}
+	return combined;
+}
+
+Frustum Frustum::toObjectSpace(const glm::dmat4& object2World) const
+{
+	// Planes transform with the transpose of the matrix that points transform with
+	Frustum result;
+	for (int i = 0; i < NUM_PLANES; i++) {
+		glm::dvec4 plane(_planes[i]);
+		result.setPlane(i, normalizePlane(plane * object2World));
+	}
+	return result;
+}
+
+void Frustum::setPlane(int plane, const glm::dvec4& equation)
+{
+	_planes[plane] = glm::vec4(equation);
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const
+{
+	for (int i = 0; i < NUM_PLANES; i++) {
+		const glm::vec4& p = _planes[i];
+		float distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+		if (!(distance >= -radius)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::intersectsBox(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+{
+	for (int i = 0; i < NUM_PLANES; i++) {
+		// The corner furthest along the plane normal
+		const glm::vec4& p = _planes[i];
+		float x = p.x >= 0.0f ? boxMax.x : boxMin.x;
+		float y = p.y >= 0.0f ? boxMax.y : boxMin.y;
+		float z = p.z >= 0.0f ? boxMax.z : boxMin.z;
+		float distance = p.x * x + p.y * y + p.z * z + p.w;
+		if (!(distance >= 0.0f)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int Frustum::cullSpheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+						 int count, unsigned char* visible) const
+{
+	int numVisible = 0;
+	int i = 0;
+#ifdef MINVR_FRUSTUM_SSE
+	for (; i + 4 <= count; i += 4) {
+		__m128 x = _mm_loadu_ps(centerX + i);
+		__m128 y = _mm_loadu_ps(centerY + i);
+		__m128 z = _mm_loadu_ps(centerZ + i);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < NUM_PLANES; p++) {
+			const glm::vec4& plane = _planes[p];
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+				_mm_mul_ps(_mm_set1_ps(plane.z), z)), _mm_set1_ps(plane.w));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+		int mask = _mm_movemask_ps(inside);
+		for (int j = 0; j < 4; j++) {
+			visible[i + j] = (mask >> j) & 1;
+			numVisible += visible[i + j];
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		visible[i] = intersectsSphere(glm::vec3(centerX[i], centerY[i], centerZ[i]), radius[i]) ? 1 : 0;
+		numVisible += visible[i];
+	}
+	return numVisible;
+}
+
+int Frustum::cullBoxes(const float* minX, const float* minY, const float* minZ,
+					   const float* maxX, const float* maxY, const float* maxZ,
+					   int count, unsigned char* visible) const
+{
+	int numVisible = 0;
+	int i = 0;
+#ifdef MINVR_FRUSTUM_SSE
+	for (; i + 4 <= count; i += 4) {
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < NUM_PLANES; p++) {
+			// The signs of the normal are the same for every box, so the corner can be picked per plane
+			const glm::vec4& plane = _planes[p];
+			__m128 x = _mm_loadu_ps((plane.x >= 0.0f ? maxX : minX) + i);
+			__m128 y = _mm_loadu_ps((plane.y >= 0.0f ? maxY : minY) + i);
+			__m128 z = _mm_loadu_ps((plane.z >= 0.0f ? maxZ : minZ) + i);
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+				_mm_mul_ps(_mm_set1_ps(plane.z), z)), _mm_set1_ps(plane.w));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+		}
+		int mask = _mm_movemask_ps(inside);
+		for (int j = 0; j < 4; j++) {
+			visible[i + j] = (mask >> j) & 1;
+			numVisible += visible[i + j];
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		visible[i] = intersectsBox(glm::vec3(minX[i], minY[i], minZ[i]), glm::vec3(maxX[i], maxY[i], maxZ[i])) ? 1 : 0;
+		numVisible += visible[i];
+	}
+	return numVisible;
+}
+
+} // end namespace
@@ -0,0 +1,240 @@
+/*
+ * Copyright Regents of the University of Minnesota, 2015.  This software is released under the following license: http://opensource.org/licenses/GPL-2.0
+ * Source code originally developed at the University of Minnesota Interactive Visualization Lab (http://ivlab.cs.umn.edu).
+ *
+ * Code author(s):
+ * 		MinVR Development Team
+ */
+
+#include "MVRCore/GLStateCache.H"
+#include <log/Logger.h>
+
+#if defined(WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <GL/gl.h>
+#elif defined(__APPLE__)
+#include <OpenGL/OpenGL.h>
+#include <OpenGL/glu.h>
+#else
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glu.h>
+#endif
+#include "GL/glext.h"
+
+#ifdef _WIN32
+	#define glBindFramebuffer	((PFNGLBINDFRAMEBUFFERPROC)_glBindFramebuffer)
+	#define glUseProgram		((PFNGLUSEPROGRAMPROC)_glUseProgram)
+	#define glBindBuffer		((PFNGLBINDBUFFERPROC)_glBindBuffer)
+	#define glBindBufferBase	((PFNGLBINDBUFFERBASEPROC)_glBindBufferBase)
+	#define glActiveTexture		((PFNGLACTIVETEXTUREPROC)_glActiveTexture)
+#endif
+
+namespace MinVR {
+
+GLStateCache::GLStateCache() : _numIssued(0), _numFiltered(0)
+{
+#ifdef _WIN32
+	_glBindFramebuffer = NULL;
+	_glUseProgram = NULL;
+	_glBindBuffer = NULL;
+	_glBindBufferBase = NULL;
+	_glActiveTexture = NULL;
+#endif
+	invalidate();
+}
+
+GLStateCache::~GLStateCache()
+{
+}
+
+void GLStateCache::initExtensions()
+{
+#ifdef _WIN32
+	_glBindFramebuffer = (GLProc)wglGetProcAddress("glBindFramebuffer");
+	_glUseProgram = (GLProc)wglGetProcAddress("glUseProgram");
+	_glBindBuffer = (GLProc)wglGetProcAddress("glBindBuffer");
+	_glBindBufferBase = (GLProc)wglGetProcAddress("glBindBufferBase");
+	_glActiveTexture = (GLProc)wglGetProcAddress("glActiveTexture");
+	if (!_glBindFramebuffer || !_glUseProgram || !_glBindBuffer || !_glActiveTexture) {
+		MinVR::Logger::getInstance().assertMessage(false, "Video card does NOT support the OpenGL calls needed by the state cache.");
+	}
+#endif
+}
+
+void GLStateCache::invalidate()
+{
+	_viewportKnown = false;
+	_scissorKnown = false;
+	_drawBufferKnown = false;
+	_readFramebufferKnown = false;
+	_drawFramebufferKnown = false;
+	_programKnown = false;
+	_activeTextureKnown = false;
+	_buffers.clear();
+	_textures.clear();
+	_capabilities.clear();
+}
+
+void GLStateCache::resetCounters()
+{
+	_numIssued = 0;
+	_numFiltered = 0;
+}
+
+bool GLStateCache::countCall(bool changed)
+{
+	if (changed) {
+		_numIssued++;
+	}
+	else {
+		_numFiltered++;
+	}
+	return changed;
+}
+
+bool GLStateCache::updateBinding(std::vector<Binding>& bindings, unsigned int unit, unsigned int target, unsigned int value)
+{
+	for (size_t i = 0; i < bindings.size(); i++) {
+		if (bindings[i].unit == unit && bindings[i].target == target) {
+			if (bindings[i].value == value) {
+				return false;
+			}
+			bindings[i].value = value;
+			return true;
+		}
+	}
+
+	Binding binding = { unit, target, value };
+	bindings.push_back(binding);
+	return true;
+}
+
+bool GLStateCache::updateRect(int* rect, bool& known, int x, int y, int width, int height)
+{
+	if (known && rect[0] == x && rect[1] == y && rect[2] == width && rect[3] == height) {
+		return false;
+	}
+	rect[0] = x;
+	rect[1] = y;
+	rect[2] = width;
+	rect[3] = height;
+	known = true;
+	return true;
+}
+
+bool GLStateCache::updateValue(unsigned int& current, bool& known, unsigned int value)
+{
+	if (known && current == value) {
+		return false;
+	}
+	current = value;
+	known = true;
+	return true;
+}
+
+void GLStateCache::viewport(int x, int y, int width, int height)
+{
+	if (countCall(updateRect(_viewport, _viewportKnown, x, y, width, height))) {
+		glViewport(x, y, width, height);
+	}
+}
+
+void GLStateCache::scissor(int x, int y, int width, int height)
+{
+	if (countCall(updateRect(_scissor, _scissorKnown, x, y, width, height))) {
+		glScissor(x, y, width, height);
+	}
+}
+
+void GLStateCache::drawBuffer(unsigned int buffer)
+{
+	if (countCall(updateValue(_drawBuffer, _drawBufferKnown, buffer))) {
+		glDrawBuffer(buffer);
+	}
+}
+
+void GLStateCache::bindFramebuffer(unsigned int target, unsigned int framebuffer)
+{
+	bool readChanged = target != GL_DRAW_FRAMEBUFFER && (!_readFramebufferKnown || _readFramebuffer != framebuffer);
+	bool drawChanged = target != GL_READ_FRAMEBUFFER && (!_drawFramebufferKnown || _drawFramebuffer != framebuffer);
+	if (!countCall(readChanged || drawChanged)) {
+		return;
+	}
+
+	if (target != GL_DRAW_FRAMEBUFFER) {
+		_readFramebuffer = framebuffer;
+		_readFramebufferKnown = true;
+	}
+	if (target != GL_READ_FRAMEBUFFER) {
+		_drawFramebuffer = framebuffer;
+		_drawFramebufferKnown = true;
+	}
+	if (drawChanged) {
+		// The draw buffer is part of the framebuffer's state
+		_drawBufferKnown = false;
+	}
+	glBindFramebuffer(target, framebuffer);
+}
+
+void GLStateCache::useProgram(unsigned int program)
+{
+	if (countCall(updateValue(_program, _programKnown, program))) {
+		glUseProgram(program);
+	}
+}
+
+void GLStateCache::bindBuffer(unsigned int target, unsigned int buffer)
+{
+	if (target == GL_ELEMENT_ARRAY_BUFFER) {
+		_numIssued++;
+		glBindBuffer(target, buffer);
+	}
+	else if (countCall(updateBinding(_buffers, 0, target, buffer))) {
+		glBindBuffer(target, buffer);
+	}
+}
+
+void GLStateCache::bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer)
+{
+	updateBinding(_buffers, 0, target, buffer);
+	_numIssued++;
+	glBindBufferBase(target, index, buffer);
+}
+
+void GLStateCache::activeTexture(unsigned int texture)
+{
+	if (countCall(updateValue(_activeTexture, _activeTextureKnown, texture))) {
+		glActiveTexture(texture);
+	}
+}
+
+void GLStateCache::bindTexture(unsigned int target, unsigned int texture)
+{
+	if (!_activeTextureKnown) {
+		// Unknown unit, so the call can't be checked or remembered
+		_numIssued++;
+		_textures.clear();
+		glBindTexture(target, texture);
+	}
+	else if (countCall(updateBinding(_textures, _activeTexture, target, texture))) {
+		glBindTexture(target, texture);
+	}
+}
+
+void GLStateCache::enable(unsigned int capability)
+{
+	if (countCall(updateBinding(_capabilities, 0, capability, GL_TRUE))) {
+		glEnable(capability);
+	}
+}
+
+void GLStateCache::disable(unsigned int capability)
+{
+	if (countCall(updateBinding(_capabilities, 0, capability, GL_FALSE))) {
+		glDisable(capability);
+	}
+}
+
+} // end namespace
@@ -36,7 +36,7 @@ GraphicsContextHolder GraphicsContext::getCurrentContext()
 		return contextMap[currentThreadId];
 	}
 
-	GraphicsContextHolder context = { -1, NULL };
+	GraphicsContextHolder context = { -1, NULL, NULL, false };
 	return context;
 }
 
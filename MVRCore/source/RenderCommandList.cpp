@@ -0,0 +1,129 @@
+/*
+ * Copyright Regents of the University of Minnesota, 2015.  This software is released under the following license: http://opensource.org/licenses/GPL-2.0
+ * Source code originally developed at the University of Minnesota Interactive Visualization Lab (http://ivlab.cs.umn.edu).
+ *
+ * Code author(s):
+ * 		MinVR Development Team
+ */
+
+#include "MVRCore/RenderCommandList.H"
+#include <glm/gtc/type_ptr.hpp>
+
+namespace MinVR {
+
+RenderCommandList::RenderCommandList()
+{
+}
+
+RenderCommandList::~RenderCommandList()
+{
+}
+
+void RenderCommandList::clear()
+{
+	_commands.clear();
+	_matrices.clear();
+	_floats.clear();
+}
+
+RenderCommandList::Command& RenderCommandList::addCommand(CommandType type)
+{
+	_commands.push_back(Command());
+	Command& command = _commands.back();
+	command.type = type;
+	command.arg[0] = command.arg[1] = command.arg[2] = command.arg[3] = 0;
+	command.data = 0;
+	return command;
+}
+
+size_t RenderCommandList::addFloats(const float* values, size_t count)
+{
+	size_t offset = _floats.size();
+	_floats.insert(_floats.end(), values, values + count);
+	return offset;
+}
+
+void RenderCommandList::setObjectToWorldMatrix(const glm::dmat4& obj2World)
+{
+	addCommand(COMMAND_OBJECT_TO_WORLD).data = _matrices.size();
+	_matrices.push_back(obj2World);
+}
+
+void RenderCommandList::useProgram(unsigned int program)
+{
+	addCommand(COMMAND_USE_PROGRAM).arg[0] = (int)program;
+}
+
+void RenderCommandList::bindVertexArray(unsigned int vertexArray)
+{
+	addCommand(COMMAND_BIND_VERTEX_ARRAY).arg[0] = (int)vertexArray;
+}
+
+void RenderCommandList::bindBuffer(unsigned int target, unsigned int buffer)
+{
+	Command& command = addCommand(COMMAND_BIND_BUFFER);
+	command.arg[0] = (int)target;
+	command.arg[1] = (int)buffer;
+}
+
+void RenderCommandList::bindTexture(int unit, unsigned int target, unsigned int texture)
+{
+	Command& command = addCommand(COMMAND_BIND_TEXTURE);
+	command.arg[0] = unit;
+	command.arg[1] = (int)target;
+	command.arg[2] = (int)texture;
+}
+
+void RenderCommandList::enable(unsigned int capability)
+{
+	addCommand(COMMAND_ENABLE).arg[0] = (int)capability;
+}
+
+void RenderCommandList::disable(unsigned int capability)
+{
+	addCommand(COMMAND_DISABLE).arg[0] = (int)capability;
+}
+
+void RenderCommandList::uniform1i(int location, int value)
+{
+	Command& command = addCommand(COMMAND_UNIFORM_1I);
+	command.arg[0] = location;
+	command.arg[1] = value;
+}
+
+void RenderCommandList::uniform4f(int location, const glm::vec4& value)
+{
+	size_t offset = addFloats(glm::value_ptr(value), 4);
+	Command& command = addCommand(COMMAND_UNIFORM_4F);
+	command.arg[0] = location;
+	command.data = offset;
+}
+
+void RenderCommandList::uniformMatrix4f(int location, const glm::mat4& value)
+{
+	size_t offset = addFloats(glm::value_ptr(value), 16);
+	Command& command = addCommand(COMMAND_UNIFORM_MATRIX_4F);
+	command.arg[0] = location;
+	command.data = offset;
+}
+
+void RenderCommandList::drawArrays(unsigned int mode, int first, int count, int instances)
+{
+	Command& command = addCommand(COMMAND_DRAW_ARRAYS);
+	command.arg[0] = (int)mode;
+	command.arg[1] = first;
+	command.arg[2] = count;
+	command.arg[3] = instances;
+}
+
+void RenderCommandList::drawElements(unsigned int mode, int count, unsigned int type, size_t offset, int instances)
+{
+	Command& command = addCommand(COMMAND_DRAW_ELEMENTS);
+	command.arg[0] = (int)mode;
+	command.arg[1] = count;
+	command.arg[2] = (int)type;
+	command.arg[3] = instances;
+	command.data = offset;
+}
+
+} // end namespace
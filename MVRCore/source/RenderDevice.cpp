@@ -7,10 +7,11 @@
  */
 
 #include <MVRCore/RenderDevice.H>
+#include <MVRCore/GraphicsContext.H>
 
 namespace MinVR {
 
-RenderDevice::RenderDevice(const WindowInfo& windowInfo, const AppInfo& appInfo) : _windowInfo(windowInfo), _appInfo(appInfo) {
+RenderDevice::RenderDevice(const WindowInfo& windowInfo, const AppInfo& appInfo, RenderCommandList* commandList) : _windowInfo(windowInfo), _appInfo(appInfo), _commandList(commandList) {
 	// TODO Auto-generated constructor stub
 
 }
@@ -19,4 +20,12 @@ RenderDevice::~RenderDevice() {
 	// TODO Auto-generated destructor stub
 }
 
+GLStateCache* RenderDevice::getStateCache() const {
+	return GraphicsContext::getCurrentContext().stateCache;
+}
+
+bool RenderDevice::isSinglePassStereo() const {
+	return GraphicsContext::getCurrentContext().singlePassStereo;
+}
+
 } /* namespace MinVR */
@@ -54,9 +54,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "MVRCore/RenderThread.H"
 #include "MVRCore/AbstractMVREngine.H"
+#include "MVRCore/CameraOffAxis.H"
 #include <log/Logger.h>
+#include <log/TraceLog.h>
+#include <log/LogRateLimiter.h>
 #include <io/FileSystem.h>
 #include "MVRCore/GraphicsContext.H"
+#include "MVRCore/Statistics.H"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 
 using namespace std;
 
@@ -100,34 +107,67 @@ RenderThread::~RenderThread()
 
 void RenderThread::render()
 {
+	TimeStamp initStart = getCurrentTime();
 	_window->makeContextCurrent();
 	
 	initExtensions();
+	_stateCache.initExtensions();
+
+	_stencilStereo = false;
+	if (_window->getSettings()->stereoComposite == WindowSettings::STEREOCOMPOSITE_STENCIL &&
+		(_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_CHECKERBOARD ||
+		 _window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDCOLUMNS ||
+		 _window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDROWS)) {
+		// The window may have fewer stencil bits than were requested, so ask the context
+		if (getWindowStencilBits() > 0) {
+			_stencilStereo = true;
+		}
+		else {
+			MINVR_LOG_WARNING("MVRCore", "Stencil stereo composite needs a stencil buffer but the window has none, using the texture composite instead");
+		}
+	}
+	_stencilMaskWidth = -1;
+	_stencilMaskHeight = -1;
+	initSinglePassStereo();
+	initDynamicResolution();
+	initGPUTimers();
+
 	initStereoFramebufferAndTextures();
 	initStereoCompositeShader();
 	setShaderVariables();
+	initCameraUniformBuffer();
 
 	GLenum err;
 	if((err = glGetError()) != GL_NO_ERROR) {
-		std::cout << "openGL ERROR before init context specific: "<<err<<std::endl;
+		MINVR_LOG_RATE_LIMITED(LOGLEVEL_ERROR, "MVRCore", "openGL ERROR before init context specific: " << err);
+		MINVR_TRACE("RenderThread {} GL error {} before init context specific", _threadId, err);
 	}
 
-	GraphicsContext::setCurrentContext({_threadId, _window});
+	GraphicsContext::setCurrentContext({_threadId, _window, &_stateCache, _singlePassStereo});
 	_engine->initializeContextSpecificVars(_threadId, _window);
 	_app->initializeContextSpecificVars(_threadId, _window);
+	_stateCache.invalidate();
 
 	if((err = glGetError()) != GL_NO_ERROR) {
-		std::cout << "openGL ERROR in start of render(): "<<err<<std::endl;
+		MINVR_LOG_RATE_LIMITED(LOGLEVEL_ERROR, "MVRCore", "openGL ERROR in start of render(): " << err);
+		MINVR_TRACE("RenderThread {} GL error {} in start of render()", _threadId, err);
 	}
 
+	Statistics::getInstance().setValue("Startup.RenderThread" + intToString(_threadId) + ".ContextInit",
+		getDurationSeconds(getDuration(getCurrentTime(), initStart)));
+
 	// Signal that the thread is initialized
 	_initMutex->lock();
 	numThreadsInitComplete++;
 	_initCond->notify_all();
 	_initMutex->unlock();
 
+	// Start of each CPU phase of the frame, with the end of the frame last
+	TimeStamp phaseStart[NUM_CPU_PHASES + 1];
+
 	bool running = true;
 	while (running) {
+		phaseStart[CPU_PHASE_WAIT] = getCurrentTime();
 
 		// Wait for the main thread to signal that it's ok to start rendering
 		UniqueMutexLock startRenderingLock(*_startRenderingMutex);
@@ -148,127 +188,127 @@ void RenderThread::render()
 		startRenderingLock.unlock();
 
 		//cout <<"\t Thread "<<_threadId<<" received start rendering"<<endl;
+		MINVR_TRACE("RenderThread {} start rendering", _threadId);
+		phaseStart[CPU_PHASE_COMPUTATION] = getCurrentTime();
+		_stateCache.resetCounters();
+		if (_gpuTimers) {
+			readGPUTimers();
+		}
+		if (_dynamicResolution) {
+			updateResolutionScales();
+		}
 		_app->perFrameComputation(_threadId, _window);
-        glEnable(GL_SCISSOR_TEST);
+
+		phaseStart[CPU_PHASE_RECORD] = getCurrentTime();
+		_commandList.clear();
+		RenderDevice recordDevice(WindowInfo({_threadId, _window, -1}), AppInfo({_app.get()}), &_commandList);
+		_replayCommands = _app->recordGraphics(recordDevice);
+		// The app may have changed OpenGL state without the cache
+		_stateCache.invalidate();
+#ifdef _WIN32
+		if (_replayCommands && (!pglBindVertexArray || !pglDrawArraysInstanced || !pglDrawElementsInstanced || !pglUniform4fv || !pglUniformMatrix4fv)) {
+			MinVR::Logger::getInstance().assertMessage(false, "Video card does NOT support the OpenGL 3.1 calls needed to replay recorded commands.");
+		}
+#endif
+
+		phaseStart[CPU_PHASE_DRAW] = getCurrentTime();
+        _stateCache.enable(GL_SCISSOR_TEST);
 
 		// Draw the scene
 		// Monoscopic
 		if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_MONO || _window->getSettings()->stereo == false) {
-			glDrawBuffer(GL_BACK);
+			_stateCache.drawBuffer(GL_BACK);
 			for (int v=0; v < _window->getNumViewports(); v++) {
-				MinVR::Rect2D viewport = _window->getViewport(v);
-				glViewport(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-				glScissor(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-                glClear(GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				_window->getCamera(v)->applyProjectionAndCameraMatrices();
-				_app->drawGraphics(_threadId, _window, v);
+				renderViewport(v, _window->getViewport(v), CameraUniformBlock::EYE_CENTER, GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			}  
 		}
 		
 		// Quad Buffered Stereo
 		else if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_QUADBUFFERED) {
 			// Left Eye
-			glDrawBuffer(GL_BACK_LEFT);
+			_stateCache.drawBuffer(GL_BACK_LEFT);
 			for (int v=0; v < _window->getNumViewports(); v++) {
-				MinVR::Rect2D viewport = _window->getViewport(v);
-				glViewport(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-				glScissor(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-                glClear(GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				_window->getCamera(v)->applyProjectionAndCameraMatricesForLeftEye();
-				_app->drawGraphics(_threadId, _window, v);
+				renderViewport(v, _window->getViewport(v), CameraUniformBlock::EYE_LEFT, GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			}
 			// Right Eye
-			glDrawBuffer(GL_BACK_RIGHT);
+			_stateCache.drawBuffer(GL_BACK_RIGHT);
 			for (int v=0; v < _window->getNumViewports(); v++) {
-				MinVR::Rect2D viewport = _window->getViewport(v);
-				glViewport(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-				glScissor(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-                glClear(GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				_window->getCamera(v)->applyProjectionAndCameraMatricesForRightEye();
-				_app->drawGraphics(_threadId, _window, v);
+				renderViewport(v, _window->getViewport(v), CameraUniformBlock::EYE_RIGHT, GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			} 
 		}
 
+		// Side by side or interlaced stereo with both eyes drawn by one drawGraphics call per viewport
+		else if (_singlePassStereo) {
+			if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_SIDEBYSIDE) {
+				_stateCache.drawBuffer(GL_BACK);
+				for (int v=0; v < _window->getNumViewports(); v++) {
+					renderViewportSinglePass(v, GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				}
+			}
+			else {
+				_stateCache.bindFramebuffer(GL_FRAMEBUFFER, _stereoFBO);
+				for (int v=0; v < _window->getNumViewports(); v++) {
+					renderViewportSinglePass(v, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				}
+				for (int v=0; v < _window->getNumViewports(); v++) {
+					setCameraProjectionOffset(v, glm::dvec2(1.0), glm::dvec2(0.0));
+				}
+				compositeEyeTextures();
+			}
+		}
+
 		// Side by Side Stereo Images, Left Eye on the left half of the screen and Right Eye on the right
 		else if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_SIDEBYSIDE) {
-			glDrawBuffer(GL_BACK);
+			_stateCache.drawBuffer(GL_BACK);
 			// Left Eye
 			for (int v=0; v < _window->getNumViewports(); v++) {
-				MinVR::Rect2D viewport = _window->getViewport(v);
-				glViewport(viewport.x0(), viewport.y0(), viewport.width()/2, viewport.height());
-                glScissor(viewport.x0(), viewport.y0(), viewport.width()/2, viewport.height());
-                glClear(GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				_window->getCamera(v)->applyProjectionAndCameraMatricesForLeftEye();
-				_app->drawGraphics(_threadId, _window, v);
+				renderViewport(v, getSideBySideViewport(v, CameraUniformBlock::EYE_LEFT), CameraUniformBlock::EYE_LEFT,
+					GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			}
 			// Right Eye
 			for (int v=0; v < _window->getNumViewports(); v++) {
-				MinVR::Rect2D viewport = _window->getViewport(v);
-				glViewport(viewport.x0()+viewport.width()/2, viewport.y0(), viewport.width()/2, viewport.height());
-                glScissor(viewport.x0()+viewport.width()/2, viewport.y0(), viewport.width()/2, viewport.height());
-                glClear(GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				_window->getCamera(v)->applyProjectionAndCameraMatricesForRightEye();
-				_app->drawGraphics(_threadId, _window, v);
+				renderViewport(v, getSideBySideViewport(v, CameraUniformBlock::EYE_RIGHT), CameraUniformBlock::EYE_RIGHT,
+					GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			} 
 		}
 
+		// Draw checkerboard or interlaced stereo straight to the back buffer, with the stencil mask selecting the eye
+		else if (_stencilStereo) {
+			_stateCache.drawBuffer(GL_BACK);
+			updateStereoStencilMask();
+			for (int v=0; v < _window->getNumViewports(); v++) {
+				// glClear ignores the stencil test, so the left eye's clear covers both eyes
+				applyStereoStencilState(0);
+				renderViewport(v, _window->getViewport(v), CameraUniformBlock::EYE_LEFT, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				applyStereoStencilState(1);
+				renderViewport(v, _window->getViewport(v), CameraUniformBlock::EYE_RIGHT, 0);
+			}
+			_stateCache.disable(GL_STENCIL_TEST);
+		}
+
 		// Draw using either checkerboard or interlaced stereo
 		else {
 			// bind a framebuffer object
-			glBindFramebuffer(GL_FRAMEBUFFER, _stereoFBO);
+			_stateCache.bindFramebuffer(GL_FRAMEBUFFER, _stereoFBO);
 		
+			// The eye textures only hold the rows or columns of the window that show that eye
 			//Set lefteye texture
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _leftEyeTexture, 0);
 			for (int v=0; v < _window->getNumViewports(); v++) {
-				MinVR::Rect2D viewport = _window->getViewport(v);
-				glViewport(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-				glScissor(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				_window->getCamera(v)->applyProjectionAndCameraMatricesForLeftEye();
-				_app->drawGraphics(_threadId, _window, v);
+				renderViewport(v, getEyeTextureViewport(v, CameraUniformBlock::EYE_LEFT), CameraUniformBlock::EYE_LEFT, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			}
 
 			//Set righteye texture
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _rightEyeTexture, 0);
 			for (int v=0; v < _window->getNumViewports(); v++) {
-				MinVR::Rect2D viewport = _window->getViewport(v);
-				glViewport(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-				glScissor(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				_window->getCamera(v)->applyProjectionAndCameraMatricesForRightEye();
-				_app->drawGraphics(_threadId, _window, v);
+				renderViewport(v, getEyeTextureViewport(v, CameraUniformBlock::EYE_RIGHT), CameraUniformBlock::EYE_RIGHT, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			}
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			glUseProgram(_stereoProgram);
-			glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
-
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, _leftEyeTexture);
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, _rightEyeTexture);
-
-			glEnableClientState(GL_VERTEX_ARRAY);
-			glVertexPointer(2, GL_FLOAT, 0, 0);
-			glDrawElements(GL_QUADS, 4, GL_UNSIGNED_INT, 0);
-			glDisableClientState(GL_VERTEX_ARRAY);
+			for (int v=0; v < _window->getNumViewports(); v++) {
+				setCameraProjectionOffset(v, glm::dvec2(1.0), glm::dvec2(0.0));
+			}
 
-			glBindBuffer(GL_ARRAY_BUFFER_ARB, 0);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glUseProgram(0);
+			compositeEyeTextures();
 		}
 
 		//cout << "\tThread "<<_threadId<<" finished rendering"<<endl;
@@ -280,10 +320,16 @@ void RenderThread::render()
 		_renderingFlushMutex->unlock();
 
 		// Wait for the other threads to get here before swapping buffers
+		phaseStart[CPU_PHASE_SWAP_WAIT] = getCurrentTime();
 		_swapBarrier->wait();
 
 		//cout << "\tThread "<<_threadId<<" swapping buffers"<<endl;
+		phaseStart[CPU_PHASE_SWAP] = getCurrentTime();
 		_window->swapBuffers();
+		phaseStart[NUM_CPU_PHASES] = getCurrentTime();
+		if (_window->getSettings()->frameTimers) {
+			publishFrameTimers(phaseStart);
+		}
 
 		// Signal that this rendering thread has completed drawing
 		_renderingCompleteMutex->lock();
@@ -293,6 +339,698 @@ void RenderThread::render()
 	}
 }
 
+void RenderThread::renderViewport(int viewportIndex, Rect2D viewport, int eye, GLbitfield clearMask)
+{
+	MinVR::Rect2D target = viewport;
+	if (_dynamicResolution) {
+		target = getScaledViewport(viewportIndex, viewport);
+		_stateCache.bindFramebuffer(GL_FRAMEBUFFER, _scaledFBO);
+	}
+	beginGPUTimer(getGPUTimer(viewportIndex, eye));
+
+	_stateCache.viewport(target.x0(), target.y0(), target.width(), target.height());
+	_stateCache.scissor(target.x0(), target.y0(), target.width(), target.height());
+	if (clearMask != 0) {
+		glClear(clearMask);
+	}
+
+	AbstractCameraRef camera = _window->getCamera(viewportIndex);
+	applyCamera(camera, eye);
+
+	if (_cameraUniformBuffer) {
+		updateCameraUniformBuffer(camera.get(), target, eye);
+	}
+
+	drawViewport(viewportIndex, camera);
+	endGPUTimer();
+
+	if (_dynamicResolution) {
+		// Stretch into the window's draw buffer, the blit is clipped by the scissor box
+		_stateCache.bindFramebuffer(GL_READ_FRAMEBUFFER, _scaledFBO);
+		_stateCache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		_stateCache.scissor(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
+		glBlitFramebuffer(target.x0(), target.y0(), target.x0() + target.width(), target.y0() + target.height(),
+			viewport.x0(), viewport.y0(), viewport.x0() + viewport.width(), viewport.y0() + viewport.height(),
+			GL_COLOR_BUFFER_BIT, GL_LINEAR);
+		_stateCache.bindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+}
+
+void RenderThread::renderViewportSinglePass(int viewportIndex, GLbitfield clearMask)
+{
+	bool sideBySide = _window->getSettings()->stereoType == WindowSettings::STEREOTYPE_SIDEBYSIDE;
+	AbstractCameraRef camera = _window->getCamera(viewportIndex);
+	CameraOffAxis* offAxis = dynamic_cast<CameraOffAxis*>(camera.get());
+
+	StereoCameraUniformBlock block;
+	memset(&block, 0, sizeof(block));
+	MinVR::Rect2D eyeViewports[2];
+	for (int i = 0; i < 2; i++) {
+		int eye = i == 0 ? CameraUniformBlock::EYE_LEFT : CameraUniformBlock::EYE_RIGHT;
+		// For the eye textures this also sets the projection offset of the eye
+		eyeViewports[i] = sideBySide ? getSideBySideViewport(viewportIndex, eye) : getEyeTextureViewport(viewportIndex, eye);
+		applyCamera(camera, eye);
+		if (offAxis != NULL) {
+			CameraUniformBlock eyeBlock;
+			offAxis->getUniformBlock(eyeBlock);
+			memcpy(block.projection[i], eyeBlock.projection, sizeof(eyeBlock.projection));
+			memcpy(block.view[i], eyeBlock.view, sizeof(eyeBlock.view));
+			memcpy(block.eyePosition[i], eyeBlock.eyePosition, sizeof(eyeBlock.eyePosition));
+		}
+		block.viewport[i][0] = (float)eyeViewports[i].x0();
+		block.viewport[i][1] = (float)eyeViewports[i].y0();
+		block.viewport[i][2] = (float)eyeViewports[i].width();
+		block.viewport[i][3] = (float)eyeViewports[i].height();
+	}
+
+	// glClear only uses the first scissor box, so clear the area of both eyes before splitting it.
+	// The eye textures use the same viewport for both layers.
+	MinVR::Rect2D clearViewport = sideBySide ? _window->getViewport(viewportIndex) : eyeViewports[0];
+	beginGPUTimer(getGPUTimer(viewportIndex, CameraUniformBlock::EYE_LEFT));
+	_stateCache.viewport(clearViewport.x0(), clearViewport.y0(), clearViewport.width(), clearViewport.height());
+	_stateCache.scissor(clearViewport.x0(), clearViewport.y0(), clearViewport.width(), clearViewport.height());
+	if (clearMask != 0) {
+		glClear(clearMask);
+	}
+	// glViewport and glScissor set every entry of the arrays, the state cache tracks them through entry 0
+	_stateCache.viewport(eyeViewports[0].x0(), eyeViewports[0].y0(), eyeViewports[0].width(), eyeViewports[0].height());
+	_stateCache.scissor(eyeViewports[0].x0(), eyeViewports[0].y0(), eyeViewports[0].width(), eyeViewports[0].height());
+	glViewportIndexedf(1, (GLfloat)eyeViewports[1].x0(), (GLfloat)eyeViewports[1].y0(), (GLfloat)eyeViewports[1].width(), (GLfloat)eyeViewports[1].height());
+	glScissorIndexed(1, eyeViewports[1].x0(), eyeViewports[1].y0(), eyeViewports[1].width(), eyeViewports[1].height());
+
+	_stateCache.bindBuffer(GL_UNIFORM_BUFFER, _stereoCameraUniformBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(StereoCameraUniformBlock), &block);
+	_stateCache.bindBuffer(GL_UNIFORM_BUFFER, 0);
+	_stateCache.bindBufferBase(GL_UNIFORM_BUFFER, StereoCameraUniformBlock::BINDING_POINT, _stereoCameraUniformBuffer);
+
+	drawViewport(viewportIndex, camera);
+	endGPUTimer();
+}
+
+void RenderThread::drawViewport(int viewportIndex, const AbstractCameraRef& camera)
+{
+	if (_replayCommands) {
+		replayCommands(camera);
+	}
+	else {
+		_app->drawGraphics(_threadId, _window, viewportIndex);
+		_stateCache.invalidate();
+	}
+}
+
+void RenderThread::replayCommands(const AbstractCameraRef& camera)
+{
+	for (int i = 0; i < _commandList.getNumCommands(); i++) {
+		const RenderCommandList::Command& command = _commandList.getCommand(i);
+		switch (command.type) {
+			case RenderCommandList::COMMAND_OBJECT_TO_WORLD:
+				camera->setObjectToWorldMatrix(_commandList.getMatrix(command.data));
+				break;
+			case RenderCommandList::COMMAND_USE_PROGRAM:
+				_stateCache.useProgram((GLuint)command.arg[0]);
+				break;
+			case RenderCommandList::COMMAND_BIND_VERTEX_ARRAY:
+				glBindVertexArray((GLuint)command.arg[0]);
+				break;
+			case RenderCommandList::COMMAND_BIND_BUFFER:
+				_stateCache.bindBuffer((GLenum)command.arg[0], (GLuint)command.arg[1]);
+				break;
+			case RenderCommandList::COMMAND_BIND_TEXTURE:
+				_stateCache.activeTexture(GL_TEXTURE0 + command.arg[0]);
+				_stateCache.bindTexture((GLenum)command.arg[1], (GLuint)command.arg[2]);
+				break;
+			case RenderCommandList::COMMAND_ENABLE:
+				_stateCache.enable((GLenum)command.arg[0]);
+				break;
+			case RenderCommandList::COMMAND_DISABLE:
+				_stateCache.disable((GLenum)command.arg[0]);
+				break;
+			case RenderCommandList::COMMAND_UNIFORM_1I:
+				glUniform1i(command.arg[0], command.arg[1]);
+				break;
+			case RenderCommandList::COMMAND_UNIFORM_4F:
+				glUniform4fv(command.arg[0], 1, _commandList.getFloats(command.data));
+				break;
+			case RenderCommandList::COMMAND_UNIFORM_MATRIX_4F:
+				glUniformMatrix4fv(command.arg[0], 1, GL_FALSE, _commandList.getFloats(command.data));
+				break;
+			case RenderCommandList::COMMAND_DRAW_ARRAYS:
+				if (command.arg[3] == 1) {
+					glDrawArrays((GLenum)command.arg[0], command.arg[1], command.arg[2]);
+				}
+				else {
+					glDrawArraysInstanced((GLenum)command.arg[0], command.arg[1], command.arg[2], command.arg[3]);
+				}
+				break;
+			case RenderCommandList::COMMAND_DRAW_ELEMENTS:
+				if (command.arg[3] == 1) {
+					glDrawElements((GLenum)command.arg[0], command.arg[1], (GLenum)command.arg[2], (const GLvoid*)command.data);
+				}
+				else {
+					glDrawElementsInstanced((GLenum)command.arg[0], command.arg[1], (GLenum)command.arg[2], (const GLvoid*)command.data, command.arg[3]);
+				}
+				break;
+		}
+	}
+
+	// The next viewport or eye applies its camera with the identity, as it would before drawGraphics
+	camera->setObjectToWorldMatrix(glm::dmat4(1.0));
+}
+
+void RenderThread::applyCamera(const AbstractCameraRef& camera, int eye)
+{
+	if (eye == CameraUniformBlock::EYE_LEFT) {
+		camera->applyProjectionAndCameraMatricesForLeftEye();
+	}
+	else if (eye == CameraUniformBlock::EYE_RIGHT) {
+		camera->applyProjectionAndCameraMatricesForRightEye();
+	}
+	else {
+		camera->applyProjectionAndCameraMatrices();
+	}
+}
+
+MinVR::Rect2D RenderThread::getSideBySideViewport(int viewportIndex, int eye)
+{
+	MinVR::Rect2D viewport = _window->getViewport(viewportIndex);
+	int x = eye == CameraUniformBlock::EYE_RIGHT ? viewport.x0() + viewport.width()/2 : viewport.x0();
+	return MinVR::Rect2D::xywh(x, viewport.y0(), viewport.width()/2, viewport.height());
+}
+
+void RenderThread::compositeEyeTextures()
+{
+	// The last timer is the composite's
+	beginGPUTimer(_numGPUTimers - 1);
+	_stateCache.bindFramebuffer(GL_FRAMEBUFFER, 0);
+	_stateCache.disable(GL_SCISSOR_TEST);
+	_stateCache.viewport(0, 0, _window->getWidth(), _window->getHeight());
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	_stateCache.enable(GL_SCISSOR_TEST);
+	_stateCache.useProgram(_stereoProgram);
+
+	if (_singlePassStereo) {
+		_stateCache.activeTexture(GL_TEXTURE0);
+		_stateCache.bindTexture(GL_TEXTURE_2D_ARRAY, _eyeTextureArray);
+	}
+	else {
+		_stateCache.activeTexture(GL_TEXTURE0);
+		_stateCache.bindTexture(GL_TEXTURE_2D, _leftEyeTexture);
+		_stateCache.activeTexture(GL_TEXTURE1);
+		_stateCache.bindTexture(GL_TEXTURE_2D, _rightEyeTexture);
+	}
+
+	// Composite each viewport, the shaders find the eye texels from the window pixel position
+	for (int v=0; v < _window->getNumViewports(); v++) {
+		MinVR::Rect2D viewport = _window->getViewport(v);
+		_stateCache.viewport(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
+		_stateCache.scissor(viewport.x0(), viewport.y0(), viewport.width(), viewport.height());
+		drawFullscreenQuad();
+	}
+
+	if (_singlePassStereo) {
+		_stateCache.activeTexture(GL_TEXTURE0);
+		_stateCache.bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	}
+	else {
+		_stateCache.activeTexture(GL_TEXTURE0);
+		_stateCache.bindTexture(GL_TEXTURE_2D, 0);
+		_stateCache.activeTexture(GL_TEXTURE1);
+		_stateCache.bindTexture(GL_TEXTURE_2D, 0);
+	}
+	_stateCache.useProgram(0);
+	endGPUTimer();
+}
+
+namespace {
+
+// Whether the current context is at least the given OpenGL version
+bool hasOpenGLVersion(int requiredMajor, int requiredMinor)
+{
+	int major = 0;
+	int minor = 0;
+	const char* version = (const char*)glGetString(GL_VERSION);
+	if (version != NULL) {
+		sscanf(version, "%d.%d", &major, &minor);
+	}
+	return major > requiredMajor || (major == requiredMajor && minor >= requiredMinor);
+}
+
+// Maps the window pixels start..start+size-1 along one axis to the eye texture texels that hold every
+// other one of them, and returns the scale and offset of normalized device coordinates that make texel
+// k sample the scene at window coordinate 2k + phase + 0.5.
+void halveAxis(int& start, int& size, double phase, double& scale, double& offset)
+{
+	int halfStart = start / 2;
+	int halfSize = (start + size + 1) / 2 - halfStart;
+	scale = (double)size / (2.0 * halfSize);
+	offset = scale + (start - phase + 0.5 - 2.0 * halfStart) / halfSize - 1.0;
+	start = halfStart;
+	size = halfSize;
+}
+
+} // end anonymous namespace
+
+Rect2D RenderThread::getEyeTextureViewport(int viewportIndex, int eye)
+{
+	MinVR::Rect2D viewport = _window->getViewport(viewportIndex);
+	int x = viewport.x0();
+	int y = viewport.y0();
+	int width = viewport.width();
+	int height = viewport.height();
+	glm::dvec2 scale(1.0);
+	glm::dvec2 offset(0.0);
+
+	// The right eye shows on odd rows or columns, see the stereo-*.frag shaders
+	double phase = eye == CameraUniformBlock::EYE_RIGHT ? 1.0 : 0.0;
+	if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDROWS) {
+		halveAxis(y, height, phase, scale.y, offset.y);
+	}
+	else if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDCOLUMNS) {
+		halveAxis(x, width, phase, scale.x, offset.x);
+	}
+	else {
+		// Checkerboard alternates the columns of each eye from row to row, so the texels are centered
+		// between them and shown up to half a pixel to either side
+		halveAxis(x, width, 0.5, scale.x, offset.x);
+	}
+
+	setCameraProjectionOffset(viewportIndex, scale, offset);
+	return MinVR::Rect2D::xywh(x, y, width, height);
+}
+
+void RenderThread::setCameraProjectionOffset(int viewportIndex, const glm::dvec2& scale, const glm::dvec2& offset)
+{
+	CameraOffAxis* offAxis = dynamic_cast<CameraOffAxis*>(_window->getCamera(viewportIndex).get());
+	if (offAxis != NULL) {
+		offAxis->setProjectionOffset(scale, offset);
+	}
+}
+
+void RenderThread::drawFullscreenQuad()
+{
+	_stateCache.bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+	_stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, 0);
+	glDrawElements(GL_QUADS, 4, GL_UNSIGNED_INT, 0);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	_stateCache.bindBuffer(GL_ARRAY_BUFFER_ARB, 0);
+	_stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
+}
+
+int RenderThread::getWindowStencilBits()
+{
+	GLint stencilBits = 0;
+	if (hasOpenGLVersion(3, 0)) {
+		// GL_STENCIL_BITS is not available in core profiles
+		glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencilBits);
+	}
+	else {
+		glGetIntegerv(GL_STENCIL_BITS, &stencilBits);
+	}
+	return stencilBits;
+}
+
+void RenderThread::applyStereoStencilState(int eye)
+{
+	// Set again for every eye, since drawGraphics may have changed any of it
+	_stateCache.enable(GL_STENCIL_TEST);
+	glStencilMask(0);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+	glStencilFunc(GL_EQUAL, eye, 1);
+}
+
+void RenderThread::updateStereoStencilMask()
+{
+	// The pattern is fixed to window pixels, so it only has to be redrawn when the window size changes
+	if (_window->getWidth() == _stencilMaskWidth && _window->getHeight() == _stencilMaskHeight) {
+		return;
+	}
+	_stencilMaskWidth = _window->getWidth();
+	_stencilMaskHeight = _window->getHeight();
+
+	GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+	_stateCache.disable(GL_DEPTH_TEST);
+	_stateCache.disable(GL_SCISSOR_TEST);
+	_stateCache.viewport(0, 0, _stencilMaskWidth, _stencilMaskHeight);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+	glStencilMask(1);
+	glClearStencil(0);
+	glClear(GL_STENCIL_BUFFER_BIT);
+	_stateCache.enable(GL_STENCIL_TEST);
+	glStencilFunc(GL_ALWAYS, 1, 1);
+	glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
+
+	_stateCache.useProgram(_stereoProgram);
+	drawFullscreenQuad();
+	_stateCache.useProgram(0);
+
+	// Keep app clears from erasing the mask
+	glStencilMask(0);
+	_stateCache.disable(GL_STENCIL_TEST);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	_stateCache.enable(GL_SCISSOR_TEST);
+	if (depthTest) {
+		_stateCache.enable(GL_DEPTH_TEST);
+	}
+}
+
+void RenderThread::initSinglePassStereo()
+{
+	WindowSettingsRef settings = _window->getSettings();
+	_singlePassStereo = false;
+	if (settings->singlePassStereo && settings->stereo && settings->stereoType != WindowSettings::STEREOTYPE_MONO) {
+		// Apps that draw one eye per call would only show the left eye
+		bool eyeTextures = !_stencilStereo && (settings->stereoType == WindowSettings::STEREOTYPE_CHECKERBOARD ||
+			settings->stereoType == WindowSettings::STEREOTYPE_INTERLACEDCOLUMNS ||
+			settings->stereoType == WindowSettings::STEREOTYPE_INTERLACEDROWS);
+
+		// Viewport arrays and layered rendering are core in OpenGL 4.1
+		bool supported = hasOpenGLVersion(4, 1);
+#ifdef _WIN32
+		supported = supported && pglViewportIndexedf && pglScissorIndexed && pglFramebufferTexture && pglTexImage3D && pglBindBufferBase;
+#endif
+
+		if (!_app->supportsSinglePassStereo()) {
+			MINVR_LOG_WARNING("MVRCore", "Single pass stereo is not supported by the app, drawing each eye separately");
+		}
+		else if (settings->stereoType != WindowSettings::STEREOTYPE_SIDEBYSIDE && !eyeTextures) {
+			MINVR_LOG_WARNING("MVRCore", "Single pass stereo only works with SideBySide stereo and the texture stereo composite, drawing each eye separately");
+		}
+		else if (!supported) {
+			MINVR_LOG_WARNING("MVRCore", "Single pass stereo needs OpenGL 4.1, drawing each eye separately");
+		}
+		else {
+			_singlePassStereo = true;
+		}
+	}
+}
+
+void RenderThread::initDynamicResolution()
+{
+	WindowSettingsRef settings = _window->getSettings();
+	_dynamicResolution = false;
+	_scaledFBO = 0;
+	if (!settings->dynamicResolution) {
+		return;
+	}
+
+	// The other stereo types interleave the eyes pixel by pixel, which a stretched image would break
+	bool windowTarget = !settings->stereo || settings->stereoType == WindowSettings::STEREOTYPE_MONO ||
+		settings->stereoType == WindowSettings::STEREOTYPE_QUADBUFFERED ||
+		(settings->stereoType == WindowSettings::STEREOTYPE_SIDEBYSIDE && !_singlePassStereo);
+	bool supported = hasOpenGLVersion(3, 3);
+#ifdef _WIN32
+	supported = supported && pglBlitFramebuffer && pglGenQueries && pglBeginQuery && pglEndQuery && pglGetQueryObjectiv && pglGetQueryObjectui64v;
+#endif
+
+	if (!windowTarget) {
+		MINVR_LOG_WARNING("MVRCore", "Dynamic resolution only works with Mono, QuadBuffered and SideBySide stereo without single pass stereo, rendering at full resolution");
+		return;
+	}
+	if (!supported) {
+		MINVR_LOG_WARNING("MVRCore", "Dynamic resolution needs OpenGL 3.3, rendering at full resolution");
+		return;
+	}
+
+	_dynamicResolution = true;
+	_resolutionScales.assign(_window->getNumViewports(), settings->maxResolutionScale);
+	_resolutionScaleNames.clear();
+	for (int v=0; v < _window->getNumViewports(); v++) {
+		_resolutionScaleNames.push_back("RenderThread" + intToString(_threadId) + ".Viewport" + intToString(v) + ".ResolutionScale");
+	}
+	_lastFrameStart = getCurrentTime();
+
+	glGenFramebuffers(1, &_scaledFBO);
+	glGenRenderbuffers(1, &_scaledColorRBO);
+	glGenRenderbuffers(1, &_scaledDepthRBO);
+	_scaledFBOWidth = 0;
+	_scaledFBOHeight = 0;
+	resizeScaledFramebuffer();
+}
+
+void RenderThread::resizeScaledFramebuffer()
+{
+	// Large enough for every viewport at the maximum scale
+	double maxScale = _window->getSettings()->maxResolutionScale;
+	int width = (int)std::ceil(_window->getWidth() * maxScale);
+	int height = (int)std::ceil(_window->getHeight() * maxScale);
+	if (width == _scaledFBOWidth && height == _scaledFBOHeight) {
+		return;
+	}
+	_scaledFBOWidth = width;
+	_scaledFBOHeight = height;
+
+	glBindRenderbuffer(GL_RENDERBUFFER, _scaledColorRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, _scaledDepthRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	_stateCache.bindFramebuffer(GL_FRAMEBUFFER, _scaledFBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _scaledColorRBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _scaledDepthRBO);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		MinVR::Logger::getInstance().assertMessage(false, "Unable to create the framebuffer for dynamic resolution.");
+	}
+	_stateCache.bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderThread::updateResolutionScales()
+{
+	resizeScaledFramebuffer();
+
+	WindowSettingsRef settings = _window->getSettings();
+	double targetFrameTime = 1.0 / settings->targetFrameRate;
+	TimeStamp now = getCurrentTime();
+	double frameTime = getDurationSeconds(getDuration(now, _lastFrameStart));
+	_lastFrameStart = now;
+
+	int numViewports = _window->getNumViewports();
+	double totalArea = 0.0;
+	for (int v=0; v < numViewports; v++) {
+		MinVR::Rect2D viewport = _window->getViewport(v);
+		totalArea += (double)viewport.width() * viewport.height();
+	}
+
+	// The GPU times are from GPU_TIMER_FRAMES frames ago
+	for (int v=0; v < numViewports; v++) {
+		double gpuTime = 0.0;
+		bool measured = true;
+		for (int eye = CameraUniformBlock::EYE_LEFT; eye <= CameraUniformBlock::EYE_RIGHT; eye++) {
+			double time = _gpuTimes[getGPUTimer(v, eye)];
+			if (time < 0.0) {
+				measured = false;
+			}
+			else {
+				gpuTime += time;
+			}
+		}
+
+		if (measured && gpuTime > 0.0 && totalArea > 0.0) {
+			// Each viewport gets a share of the frame by area, leaving some time for swapping and the app's other work
+			MinVR::Rect2D viewport = _window->getViewport(v);
+			double budget = 0.8 * targetFrameTime * viewport.width() * viewport.height() / totalArea;
+			double scale = _resolutionScales[v];
+
+			// GPU time grows with the number of pixels, the square of the scale
+			double desired = scale * std::sqrt(budget / gpuTime);
+			if (desired > scale && frameTime > 1.1 * targetFrameTime) {
+				// The frame is late for some other reason, more pixels would only make it later
+				desired = scale;
+			}
+			// Only go part of the way, timings are noisy
+			scale += 0.25 * (desired - scale);
+			_resolutionScales[v] = glm::clamp(scale, settings->minResolutionScale, settings->maxResolutionScale);
+		}
+
+		if (settings->frameTimers) {
+			Statistics::getInstance().setValue(_resolutionScaleNames[v], _resolutionScales[v]);
+		}
+	}
+}
+
+void RenderThread::initGPUTimers()
+{
+	WindowSettingsRef settings = _window->getSettings();
+	int numViewports = _window->getNumViewports();
+	_gpuTimers = false;
+	_numGPUTimers = 2 * numViewports + 1;
+	_gpuTimerFrame = 0;
+
+	std::string prefix = "RenderThread" + intToString(_threadId) + ".";
+	const char* phaseNames[NUM_CPU_PHASES] = { "Wait", "Computation", "Record", "Draw", "SwapWait", "Swap" };
+	_cpuPhaseNames.clear();
+	for (int i = 0; i < NUM_CPU_PHASES; i++) {
+		_cpuPhaseNames.push_back(prefix + "CPU." + phaseNames[i]);
+	}
+	_glCallNames[0] = prefix + "GL.IssuedCalls";
+	_glCallNames[1] = prefix + "GL.FilteredCalls";
+
+	if (!settings->frameTimers && !_dynamicResolution) {
+		return;
+	}
+	bool supported = hasOpenGLVersion(3, 3);
+#ifdef _WIN32
+	supported = supported && pglGenQueries && pglBeginQuery && pglEndQuery && pglGetQueryObjectiv && pglGetQueryObjectui64v;
+#endif
+	if (!supported) {
+		MINVR_LOG_WARNING("MVRCore", "GPU frame timers need OpenGL 3.3, only the CPU times are reported");
+		return;
+	}
+
+	_gpuTimers = true;
+	_gpuTimerQueries.resize(GPU_TIMER_FRAMES * _numGPUTimers);
+	glGenQueries((GLsizei)_gpuTimerQueries.size(), &_gpuTimerQueries[0]);
+	_gpuTimerIssued.assign(_gpuTimerQueries.size(), false);
+	_gpuTimes.assign(_numGPUTimers, 0.0);
+
+	// Name the timers after the eyes this window draws
+	bool stereo = settings->stereo && settings->stereoType != WindowSettings::STEREOTYPE_MONO;
+	_gpuTimerNames.assign(_numGPUTimers, "");
+	for (int v=0; v < numViewports; v++) {
+		std::string viewportName = prefix + "GPU.Viewport" + intToString(v) + ".";
+		if (!stereo) {
+			_gpuTimerNames[getGPUTimer(v, CameraUniformBlock::EYE_CENTER)] = viewportName + "Center";
+		}
+		else if (_singlePassStereo) {
+			_gpuTimerNames[getGPUTimer(v, CameraUniformBlock::EYE_LEFT)] = viewportName + "BothEyes";
+		}
+		else {
+			_gpuTimerNames[getGPUTimer(v, CameraUniformBlock::EYE_LEFT)] = viewportName + "Left";
+			_gpuTimerNames[getGPUTimer(v, CameraUniformBlock::EYE_RIGHT)] = viewportName + "Right";
+		}
+	}
+	if (stereo && !_stencilStereo && (settings->stereoType == WindowSettings::STEREOTYPE_CHECKERBOARD ||
+		settings->stereoType == WindowSettings::STEREOTYPE_INTERLACEDCOLUMNS ||
+		settings->stereoType == WindowSettings::STEREOTYPE_INTERLACEDROWS)) {
+		_gpuTimerNames[_numGPUTimers - 1] = prefix + "GPU.Composite";
+	}
+}
+
+int RenderThread::getGPUTimer(int viewportIndex, int eye)
+{
+	return viewportIndex * 2 + (eye == CameraUniformBlock::EYE_RIGHT ? 1 : 0);
+}
+
+void RenderThread::beginGPUTimer(int timer)
+{
+	if (_gpuTimers) {
+		int query = (_gpuTimerFrame % GPU_TIMER_FRAMES) * _numGPUTimers + timer;
+		glBeginQuery(GL_TIME_ELAPSED, _gpuTimerQueries[query]);
+		_gpuTimerIssued[query] = true;
+	}
+}
+
+void RenderThread::endGPUTimer()
+{
+	if (_gpuTimers) {
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+}
+
+void RenderThread::readGPUTimers()
+{
+	// This frame reuses the queries issued GPU_TIMER_FRAMES frames ago.  Ones that aren't done yet
+	// are skipped rather than waited for.
+	_gpuTimerFrame++;
+	int first = (_gpuTimerFrame % GPU_TIMER_FRAMES) * _numGPUTimers;
+	for (int t = 0; t < _numGPUTimers; t++) {
+		_gpuTimes[t] = 0.0;
+		if (!_gpuTimerIssued[first + t]) {
+			continue;
+		}
+		_gpuTimerIssued[first + t] = false;
+
+		GLint available = 0;
+		glGetQueryObjectiv(_gpuTimerQueries[first + t], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			_gpuTimes[t] = -1.0;
+			continue;
+		}
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(_gpuTimerQueries[first + t], GL_QUERY_RESULT, &elapsed);
+		_gpuTimes[t] = (double)elapsed * 1e-9;
+	}
+}
+
+void RenderThread::publishFrameTimers(const TimeStamp* phaseStart)
+{
+	Statistics& statistics = Statistics::getInstance();
+	for (int i = 0; i < NUM_CPU_PHASES; i++) {
+		statistics.setValue(_cpuPhaseNames[i], getDurationSeconds(getDuration(phaseStart[i + 1], phaseStart[i])));
+	}
+	statistics.setValue(_glCallNames[0], _stateCache.getNumIssued());
+	statistics.setValue(_glCallNames[1], _stateCache.getNumFiltered());
+	if (_gpuTimers) {
+		for (int t = 0; t < _numGPUTimers; t++) {
+			if (!_gpuTimerNames[t].empty() && _gpuTimes[t] > 0.0) {
+				statistics.setValue(_gpuTimerNames[t], _gpuTimes[t]);
+			}
+		}
+	}
+}
+
+Rect2D RenderThread::getScaledViewport(int viewportIndex, Rect2D viewport)
+{
+	double scale = _resolutionScales[viewportIndex];
+	int x = (int)(viewport.x0() * scale);
+	int y = (int)(viewport.y0() * scale);
+	int width = glm::max((int)(viewport.width() * scale + 0.5), 1);
+	int height = glm::max((int)(viewport.height() * scale + 0.5), 1);
+	return MinVR::Rect2D::xywh(x, y, width, height);
+}
+
+void RenderThread::initCameraUniformBuffer()
+{
+	_cameraUniformBuffer = 0;
+	_stereoCameraUniformBuffer = 0;
+	if (_singlePassStereo) {
+		glGenBuffers(1, &_stereoCameraUniformBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, _stereoCameraUniformBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(StereoCameraUniformBlock), NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glBindBufferBase(GL_UNIFORM_BUFFER, StereoCameraUniformBlock::BINDING_POINT, _stereoCameraUniformBuffer);
+		return;
+	}
+
+	if (!_window->getSettings()->contextVersion.isCoreProfile()) {
+		return;
+	}
+
+	glGenBuffers(1, &_cameraUniformBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, _cameraUniformBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniformBlock), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, CameraUniformBlock::BINDING_POINT, _cameraUniformBuffer);
+}
+
+void RenderThread::updateCameraUniformBuffer(AbstractCamera* camera, Rect2D viewport, int eye)
+{
+	CameraOffAxis* offAxis = dynamic_cast<CameraOffAxis*>(camera);
+	if (offAxis == NULL) {
+		return;
+	}
+
+	CameraUniformBlock block;
+	offAxis->getUniformBlock(block);
+	block.viewport[0] = (float)viewport.x0();
+	block.viewport[1] = (float)viewport.y0();
+	block.viewport[2] = (float)viewport.width();
+	block.viewport[3] = (float)viewport.height();
+	block.eyeIndex = eye;
+	block.padding[0] = block.padding[1] = block.padding[2] = 0;
+
+	_stateCache.bindBuffer(GL_UNIFORM_BUFFER, _cameraUniformBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraUniformBlock), &block);
+	_stateCache.bindBuffer(GL_UNIFORM_BUFFER, 0);
+	// Rebind in case the app used the binding point for one of its own buffers
+	_stateCache.bindBufferBase(GL_UNIFORM_BUFFER, CameraUniformBlock::BINDING_POINT, _cameraUniformBuffer);
+}
+
 void RenderThread::initExtensions()
 {
 #ifdef _WIN32
@@ -305,6 +1043,7 @@ void RenderThread::initExtensions()
 	pglGenerateMipmap                      = (PFNGLGENERATEMIPMAPPROC)wglGetProcAddress("glGenerateMipmap");
 	pglFramebufferTexture2D                = (PFNGLFRAMEBUFFERTEXTURE2DPROC)wglGetProcAddress("glFramebufferTexture2D");
 	pglFramebufferRenderbuffer             = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)wglGetProcAddress("glFramebufferRenderbuffer");
+	pglBlitFramebuffer                     = (PFNGLBLITFRAMEBUFFERPROC)wglGetProcAddress("glBlitFramebuffer");
 	pglGenRenderbuffers                    = (PFNGLGENRENDERBUFFERSPROC)wglGetProcAddress("glGenRenderbuffers");
 	pglDeleteRenderbuffers                 = (PFNGLDELETERENDERBUFFERSPROC)wglGetProcAddress("glDeleteRenderbuffers");
 	pglBindRenderbuffer                    = (PFNGLBINDRENDERBUFFERPROC)wglGetProcAddress("glBindRenderbuffer");
@@ -334,6 +1073,8 @@ void RenderThread::initExtensions()
 	pglGetUniformLocation = (PFNGLGETUNIFORMLOCATIONPROC)wglGetProcAddress("glGetUniformLocation");
 	pglUniform2f = (PFNGLUNIFORM2FPROC)wglGetProcAddress("glUniform2f");
 	pglUniform1i = (PFNGLUNIFORM1IPROC)wglGetProcAddress("glUniform1i");
+	pglUniform4fv = (PFNGLUNIFORM4FVPROC)wglGetProcAddress("glUniform4fv");
+	pglUniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)wglGetProcAddress("glUniformMatrix4fv");
 
 	if (!pglCreateProgram || !pglCreateShader || !pglShaderSource || !pglCompileShader || !pglGetObjectParameterivARB ||
 		!pglAttachShader || !pglLinkProgram || !pglGetShaderiv || !pglGetProgramivARB || !pglUseProgram ||
@@ -345,17 +1086,43 @@ void RenderThread::initExtensions()
 	pglBindBuffer = (PFNGLBINDBUFFERPROC)wglGetProcAddress("glBindBuffer");
 	pglGenBuffers = (PFNGLGENBUFFERSPROC)wglGetProcAddress("glGenBuffers");
 	pglBufferData = (PFNGLBUFFERDATAPROC)wglGetProcAddress("glBufferData");
+	pglBufferSubData = (PFNGLBUFFERSUBDATAPROC)wglGetProcAddress("glBufferSubData");
 
-	if (!pglBindBuffer || !pglGenBuffers || !pglBufferData) {
+	if (!pglBindBuffer || !pglGenBuffers || !pglBufferData || !pglBufferSubData) {
 		MinVR::Logger::getInstance().assertMessage(false, "Video card does NOT support vertex buffer objects.");
 	}
 
+	// Only needed to replay recorded commands, checked when an app records them
+	pglBindVertexArray = (PFNGLBINDVERTEXARRAYPROC)wglGetProcAddress("glBindVertexArray");
+	pglDrawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDPROC)wglGetProcAddress("glDrawArraysInstanced");
+	pglDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDPROC)wglGetProcAddress("glDrawElementsInstanced");
+
+	// Uniform buffer objects are only needed for the camera uniform buffer in core profile contexts
+	pglBindBufferBase = (PFNGLBINDBUFFERBASEPROC)wglGetProcAddress("glBindBufferBase");
+
+	if (!pglBindBufferBase && _window->getSettings()->contextVersion.isCoreProfile()) {
+		MinVR::Logger::getInstance().assertMessage(false, "Video card does NOT support uniform buffer objects.");
+	}
+
 	pglActiveTexture = (PFNGLACTIVETEXTUREPROC)wglGetProcAddress("glActiveTexture");
 
 	if (!pglActiveTexture) {
 		MinVR::Logger::getInstance().assertMessage(false, "Video card does NOT support glActiveTexture");
 	}
 
+	// Only needed for dynamic resolution, which falls back to full resolution without them
+	pglGenQueries = (PFNGLGENQUERIESPROC)wglGetProcAddress("glGenQueries");
+	pglBeginQuery = (PFNGLBEGINQUERYPROC)wglGetProcAddress("glBeginQuery");
+	pglEndQuery = (PFNGLENDQUERYPROC)wglGetProcAddress("glEndQuery");
+	pglGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)wglGetProcAddress("glGetQueryObjectiv");
+	pglGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)wglGetProcAddress("glGetQueryObjectui64v");
+
+	// Only needed for single pass stereo, which falls back to drawing each eye separately without them
+	pglTexImage3D = (PFNGLTEXIMAGE3DPROC)wglGetProcAddress("glTexImage3D");
+	pglViewportIndexedf = (PFNGLVIEWPORTINDEXEDFPROC)wglGetProcAddress("glViewportIndexedf");
+	pglScissorIndexed = (PFNGLSCISSORINDEXEDPROC)wglGetProcAddress("glScissorIndexed");
+	pglFramebufferTexture = (PFNGLFRAMEBUFFERTEXTUREPROC)wglGetProcAddress("glFramebufferTexture");
+
 #endif
 }
 
@@ -373,10 +1140,15 @@ void RenderThread::initStereoCompositeShader()
 	
 		std::string vertexShaderName = DataFileUtils::findDataFile("shaders/stereo.vert");
 		MinVR::Logger::getInstance().assertMessage(MinVR::FileSystem::getInstance().exists(vertexShaderName), "Unable to load vertex shader for stereo in RenderThread.cpp. File not found");
-		const char* vs = readWholeFile(vertexShaderName).c_str();
+		// The mapped files must stay alive until glShaderSource has copied the source
+		MappedFileRef vs = MinVR::FileSystem::getInstance().mapFile(vertexShaderName);
+		MinVR::Logger::getInstance().assertMessage(vs != nullptr, "Unable to read vertex shader for stereo in RenderThread.cpp.");
 
 		std::string fragShaderName = "";
-		if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_CHECKERBOARD) {
+		if (_stencilStereo) {
+			fragShaderName = DataFileUtils::findDataFile("shaders/stereo-mask.frag");
+		}
+		else if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_CHECKERBOARD) {
 			fragShaderName = DataFileUtils::findDataFile("shaders/stereo-checkerboard.frag");
 		}
 		else if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDCOLUMNS) {
@@ -387,10 +1159,19 @@ void RenderThread::initStereoCompositeShader()
 		}
 
 		MinVR::Logger::getInstance().assertMessage(MinVR::FileSystem::getInstance().exists(fragShaderName), "Unable to load fragment shader for stereo in RenderThread.cpp. File not found");
-		const char* fs = readWholeFile(fragShaderName).c_str();
-	
-		glShaderSource(vertexShader, 1, &vs,NULL);
-		glShaderSource(fragmentShader, 1, &fs,NULL);
+		MappedFileRef fs = MinVR::FileSystem::getInstance().mapFile(fragShaderName);
+		MinVR::Logger::getInstance().assertMessage(fs != nullptr, "Unable to read fragment shader for stereo in RenderThread.cpp.");
+
+		// The assertions do nothing in release builds, so a file that is missing or can't be mapped gives an
+		// empty source and a compile error, as it did before the files were mapped, rather than a crash
+		const GLchar* vsSource = vs != nullptr ? vs->getData() : "";
+		const GLint vsLength = vs != nullptr ? (GLint)vs->getSize() : 0;
+		glShaderSource(vertexShader, 1, &vsSource, &vsLength);
+
+		// The composite shaders read both eyes from one texture array with single pass stereo
+		const GLchar* fsSources[2] = { _singlePassStereo ? "#define MINVR_EYE_TEXTURE_ARRAY\n" : "", fs != nullptr ? fs->getData() : "" };
+		const GLint fsLengths[2] = { -1, fs != nullptr ? (GLint)fs->getSize() : 0 };
+		glShaderSource(fragmentShader, 2, fsSources, fsLengths);
 	
 		glCompileShader(vertexShader);
 		glCompileShader(fragmentShader);
@@ -410,41 +1191,82 @@ void RenderThread::initStereoFramebufferAndTextures() {
 		_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDCOLUMNS ||
 		_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDROWS) {
 
-		// Create eye textures
-		glGenTextures(1, &_leftEyeTexture);
-		glGenTextures(1, &_rightEyeTexture);
-
-		glBindTexture(GL_TEXTURE_2D, _leftEyeTexture);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR); 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _window->getWidth(), _window->getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); 
-
-		glBindTexture(GL_TEXTURE_2D, _rightEyeTexture);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR); 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _window->getWidth(), _window->getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); 
-
-		glBindTexture(GL_TEXTURE_2D, 0);
+		initFullscreenQuad();
+		if (_stencilStereo) {
+			// Both eyes are drawn straight to the back buffer
+			return;
+		}
+
+		// Each eye only shows on every other row or column of the window
+		_eyeTextureWidth = _window->getWidth();
+		_eyeTextureHeight = _window->getHeight();
+		if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDROWS) {
+			_eyeTextureHeight = (_eyeTextureHeight + 1) / 2;
+		}
+		else {
+			_eyeTextureWidth = (_eyeTextureWidth + 1) / 2;
+		}
+
+		if (_singlePassStereo) {
+			// Both eyes in the layers of one texture array, rendered to as a layered framebuffer
+			glGenTextures(1, &_eyeTextureArray);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, _eyeTextureArray);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, _eyeTextureWidth, _eyeTextureHeight, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+			// Layered framebuffers need layered depth as well, so this is a texture instead of a renderbuffer
+			glGenTextures(1, &_depthTextureArray);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, _depthTextureArray);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, _eyeTextureWidth, _eyeTextureHeight, 2, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+			glGenFramebuffers(1, &_stereoFBO);
+			glBindFramebuffer(GL_FRAMEBUFFER, _stereoFBO);
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, _eyeTextureArray, 0);
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _depthTextureArray, 0);
+		}
+		else {
+			// Create eye textures
+			glGenTextures(1, &_leftEyeTexture);
+			glGenTextures(1, &_rightEyeTexture);
+
+			glBindTexture(GL_TEXTURE_2D, _leftEyeTexture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); 
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _eyeTextureWidth, _eyeTextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); 
+
+			glBindTexture(GL_TEXTURE_2D, _rightEyeTexture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); 
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _eyeTextureWidth, _eyeTextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); 
+
+			glBindTexture(GL_TEXTURE_2D, 0);
 	
-		// Setup framebuffer object
-		glGenFramebuffers(1, &_stereoFBO);
-		glBindFramebuffer(GL_FRAMEBUFFER, _stereoFBO);
+			// Setup framebuffer object
+			glGenFramebuffers(1, &_stereoFBO);
+			glBindFramebuffer(GL_FRAMEBUFFER, _stereoFBO);
 
-		// create a renderbuffer object to store depth info
-		glGenRenderbuffers(1, &_depthRBO);
-		glBindRenderbuffer(GL_RENDERBUFFER, _depthRBO);
-		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, _window->getWidth(), _window->getHeight());
-		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+			// create a renderbuffer object to store depth info
+			glGenRenderbuffers(1, &_depthRBO);
+			glBindRenderbuffer(GL_RENDERBUFFER, _depthRBO);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, _eyeTextureWidth, _eyeTextureHeight);
+			glBindRenderbuffer(GL_RENDERBUFFER, 0);
 
-		// attach a texture to FBO color attachement point
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _leftEyeTexture, 0);
+			// attach a texture to FBO color attachement point
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _leftEyeTexture, 0);
 
-		// attach a renderbuffer to depth attachment point
-		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthRBO);
+			// attach a renderbuffer to depth attachment point
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthRBO);
+		}
 
 		// check FBO status
 		GLenum e = glCheckFramebufferStatus(GL_FRAMEBUFFER);
@@ -477,33 +1299,40 @@ void RenderThread::initStereoFramebufferAndTextures() {
 		}
 
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-		//Setup fullscreen quad vbo
-		_fullscreenVertices[0] = -1.0;
-		_fullscreenVertices[1] = -1.0;
-		_fullscreenVertices[2] = 1.0;
-		_fullscreenVertices[3] = -1.0;
-		_fullscreenVertices[4] = 1.0;
-		_fullscreenVertices[5] = 1.0;
-		_fullscreenVertices[6] = -1.0;
-		_fullscreenVertices[7] =  1.0;
-		_fullscreenIndices[0] = 0;
-		_fullscreenIndices[1] = 1;
-		_fullscreenIndices[2] = 2;
-		_fullscreenIndices[3] = 3;
-
-		//Create VBO
-		glGenBuffers( 1, &_vertexBuffer );
-		glBindBuffer( GL_ARRAY_BUFFER, _vertexBuffer );
-		glBufferData( GL_ARRAY_BUFFER, 8 * sizeof(GLfloat), _fullscreenVertices, GL_STATIC_DRAW );
-
-		//Create IBO
-		glGenBuffers( 1, &_indexBuffer );
-		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indexBuffer );
-		glBufferData( GL_ELEMENT_ARRAY_BUFFER, 4 * sizeof(GLuint), _fullscreenIndices, GL_STATIC_DRAW );
 	}
 }
 
+void RenderThread::initFullscreenQuad()
+{
+	//Setup fullscreen quad vbo
+	_fullscreenVertices[0] = -1.0;
+	_fullscreenVertices[1] = -1.0;
+	_fullscreenVertices[2] = 1.0;
+	_fullscreenVertices[3] = -1.0;
+	_fullscreenVertices[4] = 1.0;
+	_fullscreenVertices[5] = 1.0;
+	_fullscreenVertices[6] = -1.0;
+	_fullscreenVertices[7] =  1.0;
+	_fullscreenIndices[0] = 0;
+	_fullscreenIndices[1] = 1;
+	_fullscreenIndices[2] = 2;
+	_fullscreenIndices[3] = 3;
+
+	//Create VBO
+	glGenBuffers( 1, &_vertexBuffer );
+	glBindBuffer( GL_ARRAY_BUFFER, _vertexBuffer );
+	glBufferData( GL_ARRAY_BUFFER, 8 * sizeof(GLfloat), _fullscreenVertices, GL_STATIC_DRAW );
+
+	//Create IBO
+	glGenBuffers( 1, &_indexBuffer );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indexBuffer );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, 4 * sizeof(GLuint), _fullscreenIndices, GL_STATIC_DRAW );
+
+	// Left bound, the buffers would turn client side arrays in the app's first frame into offsets
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+}
+
 void RenderThread::setShaderVariables()
 {
 	// Only bother if we actually need the textures and fbo for stereo
@@ -513,8 +1342,29 @@ void RenderThread::setShaderVariables()
 	{
 		glUseProgram(_stereoProgram);
 
-		GLint screenSizeLoc = glGetUniformLocation(_stereoProgram, "screenSize");
-		glUniform2f(screenSizeLoc, (GLfloat)_window->getWidth(), (GLfloat)_window->getHeight());
+		if (_stencilStereo) {
+			GLint patternLoc = glGetUniformLocation(_stereoProgram, "pattern");
+			if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_CHECKERBOARD) {
+				glUniform1i(patternLoc, 0);
+			}
+			else if (_window->getSettings()->stereoType == WindowSettings::STEREOTYPE_INTERLACEDCOLUMNS) {
+				glUniform1i(patternLoc, 1);
+			}
+			else {
+				glUniform1i(patternLoc, 2);
+			}
+			glUseProgram(0);
+			return;
+		}
+
+		GLint eyeTextureSizeLoc = glGetUniformLocation(_stereoProgram, "eyeTextureSize");
+		glUniform2f(eyeTextureSizeLoc, (GLfloat)_eyeTextureWidth, (GLfloat)_eyeTextureHeight);
+
+		if (_singlePassStereo) {
+			glUniform1i(glGetUniformLocation(_stereoProgram, "eyeTextures"), 0);
+			glUseProgram(0);
+			return;
+		}
 
 		GLuint leftEyeTexLoc  = glGetUniformLocation(_stereoProgram, "leftEyeTexture");
 		GLuint rightEyeTexLoc = glGetUniformLocation(_stereoProgram, "rightEyeTexture");
@@ -0,0 +1,88 @@
+/*
+ * Copyright Regents of the University of Minnesota, 2015.  This software is released under the following license: http://opensource.org/licenses/GPL-2.0
+ * Source code originally developed at the University of Minnesota Interactive Visualization Lab (http://ivlab.cs.umn.edu).
+ *
+ * Code author(s):
+ * 		MinVR Development Team
+ */
+
+#include <MVRCore/Statistics.H>
+
+namespace MinVR {
+
+Statistics& Statistics::getInstance()
+{
+	static Statistics instance;
+	return instance;
+}
+
+void Statistics::setValue(const std::string& name, double value)
+{
+	UniqueMutexLock lock(_mutex);
+	std::unordered_map<std::string, double>::iterator it = _values.find(name);
+	if (it == _values.end()) {
+		_names.push_back(name);
+		_values[name] = value;
+	}
+	else {
+		it->second = value;
+	}
+}
+
+void Statistics::addToValue(const std::string& name, double amount)
+{
+	UniqueMutexLock lock(_mutex);
+	std::unordered_map<std::string, double>::iterator it = _values.find(name);
+	if (it == _values.end()) {
+		_names.push_back(name);
+		_values[name] = amount;
+	}
+	else {
+		it->second += amount;
+	}
+}
+
+double Statistics::getValue(const std::string& name, double defaultValue)
+{
+	UniqueMutexLock lock(_mutex);
+	std::unordered_map<std::string, double>::iterator it = _values.find(name);
+	if (it == _values.end()) {
+		return defaultValue;
+	}
+	return it->second;
+}
+
+bool Statistics::hasValue(const std::string& name)
+{
+	UniqueMutexLock lock(_mutex);
+	return _values.find(name) != _values.end();
+}
+
+std::vector<std::string> Statistics::getNames(const std::string& prefix)
+{
+	UniqueMutexLock lock(_mutex);
+	std::vector<std::string> names;
+	for (int i = 0; i < _names.size(); i++) {
+		if (_names[i].compare(0, prefix.size(), prefix) == 0) {
+			names.push_back(_names[i]);
+		}
+	}
+	return names;
+}
+
+void Statistics::clear(const std::string& prefix)
+{
+	UniqueMutexLock lock(_mutex);
+	std::vector<std::string> remaining;
+	for (int i = 0; i < _names.size(); i++) {
+		if (_names[i].compare(0, prefix.size(), prefix) == 0) {
+			_values.erase(_names[i]);
+		}
+		else {
+			remaining.push_back(_names[i]);
+		}
+	}
+	_names.swap(remaining);
+}
+
+} /* namespace MinVR */
@@ -51,6 +51,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <fstream>
 #include <cctype>
+#include <algorithm>
+#include <limits>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
 
 using namespace std;
 
@@ -126,6 +133,170 @@ std::istream & operator>> ( std::istream &is, glm::dmat4 &m) {
 		>> c >> m[0][3] >> c >> m[1][3] >> c >> m[2][3] >> c >> m[3][3] >> c >> c;
 }
 
+// Equivalent of "is >> dummy": skips whitespace and consumes any one character.
+static inline bool skipSeparator(const char *&p)
+{
+	while (isspace((unsigned char)*p)) {
+		++p;
+	}
+	if (*p == '\0') {
+		return false;
+	}
+	++p;
+	return true;
+}
+
+// Equivalent of "is >> d" for a double.  Like the stream, this reads an optional
+// sign, digits with at most one decimal point and an optional exponent, and then
+// converts only that text, so hex floats, inf and nan stop or fail as they do
+// there.  An exponent without digits fails, as it does for the stream.
+static inline bool parseReal(const char *&p, double &d)
+{
+	while (isspace((unsigned char)*p)) {
+		++p;
+	}
+	const char *start = p;
+	const char *q = p;
+	if ((*q == '+') || (*q == '-')) {
+		++q;
+	}
+	bool hasDigits = false;
+	while (isdigit((unsigned char)*q)) {
+		++q;
+		hasDigits = true;
+	}
+	if (*q == '.') {
+		++q;
+		while (isdigit((unsigned char)*q)) {
+			++q;
+			hasDigits = true;
+		}
+	}
+	if (!hasDigits) {
+		return false;
+	}
+	if ((*q == 'e') || (*q == 'E')) {
+		++q;
+		if ((*q == '+') || (*q == '-')) {
+			++q;
+		}
+		if (!isdigit((unsigned char)*q)) {
+			return false;
+		}
+		while (isdigit((unsigned char)*q)) {
+			++q;
+		}
+	}
+
+	// strtod reads past the number when it is followed by text like "x1p3", so convert a copy
+	char buffer[64];
+	std::string longNumber;
+	size_t length = q - start;
+	const char *number = buffer;
+	if (length < sizeof(buffer)) {
+		memcpy(buffer, start, length);
+		buffer[length] = '\0';
+	}
+	else {
+		longNumber.assign(start, length);
+		number = longNumber.c_str();
+	}
+
+	char *end;
+	errno = 0;
+	d = strtod(number, &end);
+	if ((end != number + length) || ((errno == ERANGE) && (fabs(d) == HUGE_VAL))) {
+		return false;
+	}
+	p = q;
+	return true;
+}
+
+// Parses "(r1c1, r1c2, ..), (r2c1, ..), .." style text with numRows rows of
+// numCols values each into values, stored row by row.  A vector is a single
+// row without the enclosing parentheses.
+static bool parseRows(const std::string &in, int numRows, int numCols, bool enclosed, double *values)
+{
+	const char *p = in.c_str();
+	if (enclosed && !skipSeparator(p)) {
+		return false;
+	}
+	for (int r = 0; r < numRows; r++) {
+		if (!skipSeparator(p)) {
+			return false;
+		}
+		for (int c = 0; c < numCols; c++) {
+			if (!parseReal(p, values[r*numCols + c]) || !skipSeparator(p)) {
+				return false;
+			}
+		}
+		if (enclosed && !skipSeparator(p)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool stringToVec2(const std::string &in, glm::dvec2 &vec2)
+{
+	double v[2];
+	if (!parseRows(in, 1, 2, false, v)) {
+		return false;
+	}
+	vec2 = glm::dvec2(v[0], v[1]);
+	return true;
+}
+
+bool stringToVec3(const std::string &in, glm::dvec3 &vec3)
+{
+	double v[3];
+	if (!parseRows(in, 1, 3, false, v)) {
+		return false;
+	}
+	vec3 = glm::dvec3(v[0], v[1], v[2]);
+	return true;
+}
+
+bool stringToVec4(const std::string &in, glm::dvec4 &vec4)
+{
+	double v[4];
+	if (!parseRows(in, 1, 4, false, v)) {
+		return false;
+	}
+	vec4 = glm::dvec4(v[0], v[1], v[2], v[3]);
+	return true;
+}
+
+bool stringToMat3(const std::string &in, glm::dmat3 &m)
+{
+	// text is row major, glm is column major
+	double v[9];
+	if (!parseRows(in, 3, 3, true, v)) {
+		return false;
+	}
+	for (int r = 0; r < 3; r++) {
+		for (int c = 0; c < 3; c++) {
+			m[c][r] = v[r*3 + c];
+		}
+	}
+	return true;
+}
+
+bool stringToMat4(const std::string &in, glm::dmat4 &m)
+{
+	// text is row major, glm is column major
+	double v[16];
+	if (!parseRows(in, 4, 4, true, v)) {
+		return false;
+	}
+	for (int r = 0; r < 4; r++) {
+		for (int c = 0; c < 4; c++) {
+			m[c][r] = v[r*4 + c];
+		}
+	}
+	return true;
+}
+
 int iMinNonNeg(int i1, int i2) 
 {
 	if (i1 < 0)
@@ -160,43 +331,102 @@ std::string trimWhitespace(const std::string& s)
     return s.substr(left, right - left + 1);
 }
 
-bool popNextToken(std::string &in, std::string &token, bool returnFalseOnSemiColon)
+bool StringView::operator==(const char *other) const
+{
+	size_t len = strlen(other);
+	return (len == _size) && (memcmp(_data, other, _size) == 0);
+}
+
+bool StringView::operator==(const StringView &other) const
+{
+	return (other._size == _size) && (memcmp(_data, other._data, _size) == 0);
+}
+
+static inline bool isTokenDelimiter(char c)
+{
+	return (c == ' ') || (c == '\t') || (c == ';') || (c == ',') || (c == '\n') || (c == '\r');
+}
+
+void StringTokenizer::skipWhitespace()
 {
-	in = trimWhitespace(in);
+	while ((_pos < _end) && iswspace(*_pos)) {
+		++_pos;
+	}
+}
+
+bool StringTokenizer::next(StringView &token, bool returnFalseOnSemiColon)
+{
+	skipWhitespace();
 
 	// if no more tokens, return false
-	if (in.size() == 0) {
+	if (_pos == _end) {
+		return false;
+	}
+	else if ((*_pos == ';') && (returnFalseOnSemiColon)) {
+		++_pos;
 		return false;
 	}
-	else if ((in[0] == ';') && (returnFalseOnSemiColon)) {
-		in = in.substr(1);
+
+	const char *start = _pos;
+	while ((_pos < _end) && !isTokenDelimiter(*_pos)) {
+		++_pos;
+	}
+	token = StringView(start, _pos - start);
+	return !token.empty();
+}
+
+bool StringTokenizer::nextUntilSemicolon(StringView &popped)
+{
+	const char *semi = (const char*)memchr(_pos, ';', _end - _pos);
+	if (semi == NULL) {
 		return false;
 	}
+	popped = StringView(_pos, semi - _pos);
+	_pos = semi + 1;
+	return true;
+}
 
-	int end = in.size();
-	end = iMinNonNeg(end, in.find(" "));
-	end = iMinNonNeg(end, in.find('\t'));
-	end = iMinNonNeg(end, in.find(";"));
-	end = iMinNonNeg(end, in.find(","));
-	end = iMinNonNeg(end, in.find('\n'));
-	end = iMinNonNeg(end, in.find('\r'));
+bool popNextToken(std::string &in, std::string &token, bool returnFalseOnSemiColon)
+{
+	StringTokenizer tokenizer(in);
+	StringView piece;
+	bool found = tokenizer.next(piece, returnFalseOnSemiColon);
+	if (piece.data() != NULL) {
+		// set even when empty, i.e. when the input starts with a delimiter
+		token = piece.str();
+	}
 
-	token = in.substr(0,end);
-	in = in.substr(end);
-	return (token.size() > 0);
+	// the rest of the string has its trailing whitespace trimmed, as before
+	StringView rest = tokenizer.remaining();
+	size_t restSize = rest.size();
+	while ((restSize > 0) && iswspace(rest[restSize-1])) {
+		--restSize;
+	}
+	in.assign(rest.data(), restSize);
+	return found;
 }
 
 std::vector<std::string> splitStringIntoArray(const std::string &in)
 {
 	std::vector<std::string> a;
-	std::string s = in;
-	std::string token;
-	while (popNextToken(s, token, false)) {
-		a.push_back(token);
+	StringTokenizer tokenizer(in);
+	StringView token;
+	while (tokenizer.next(token, false)) {
+		a.push_back(token.str());
 	}
 	return a;
 }
 
+void splitStringIntoViews(const std::string &in, std::vector<StringView> &tokens)
+{
+	tokens.clear();
+	StringTokenizer tokenizer(in);
+	StringView token;
+	while (tokenizer.next(token, false)) {
+		tokens.push_back(token);
+	}
+}
+
 std::string decygifyPath(const std::string &in)
 {
 #ifdef WIN32
@@ -291,65 +521,177 @@ std::string	joinIntoString( const std::vector<std::string>& in, const std::strin
 
 
 
-std::vector< std::vector< std::string > > readDelimitedData(const std::string &csvString, const std::string &delimiter,	bool removeQuotes)
+// Copies a field into buf as a null terminated string for strtod/strtol.
+// Short fields, which is nearly all of them, stay on the stack.
+class NullTerminatedField
 {
-	std::vector< std::vector< std::string> > data;
-	std::string csv;
-
-	// first remove '\r' characters to make DOS/Windows style returns
-	// look like unix
-	for (int i=0;i<csvString.length();i++) {
-		if (csvString[i] != '\r')
-			csv = csv + csvString[i];
-	}
-
-	bool done=false;
-	while ((!done) && (csv.length())) {
-		int nl = csv.find("\n");
-		int l = csv.length();
-		int endofline = iMinNonNeg(nl, l);
-		if (endofline > 0) {
-			std::string line = csv.substr(0,endofline);
-			std::vector<std::string> dataLine;
-
-			while (line.length() > 0) {
-				int end = iMinNonNeg(line.find(delimiter), line.length());
-				std::string item = line.substr(0,end);
-				if ((removeQuotes) && (item[0] == '"') && (item[item.length()-1] == '"'))
-					item = item.substr(1,item.length()-2);
-				dataLine.push_back(item);
-				if (end+1 >= line.length()) {
-					if (line[line.length()-1] == ',')
-						dataLine.push_back("");
-					line = "";
-				}
-				else
-					line = line.substr(end+1);
-			}
+public:
+	NullTerminatedField(const StringView &in) {
+		if (in.size() < sizeof(_local)) {
+			memcpy(_local, in.data(), in.size());
+			_local[in.size()] = '\0';
+			_str = _local;
+		}
+		else {
+			_heap = in.str();
+			_str = _heap.c_str();
+		}
+	}
+
+	const char* c_str() const { return _str; }
 
-			if (dataLine.size())
-				data.push_back(dataLine);
+private:
+	char _local[64];
+	std::string _heap;
+	const char *_str;
+};
 
-			csv = csv.substr(endofline+1);
+// true if only whitespace is left after a number
+static inline bool onlyWhitespace(const char *p)
+{
+	while (isspace((unsigned char)*p)) {
+		++p;
+	}
+	return *p == '\0';
+}
+
+bool stringToInt(const StringView &in, int &i)
+{
+	NullTerminatedField field(in);
+	char *end;
+	errno = 0;
+	long l = strtol(field.c_str(), &end, 10);
+	if ((end == field.c_str()) || (errno == ERANGE) || !onlyWhitespace(end) ||
+		(l < std::numeric_limits<int>::min()) || (l > std::numeric_limits<int>::max())) {
+		return false;
+	}
+	i = (int)l;
+	return true;
+}
+
+bool stringToReal(const StringView &in, double &r)
+{
+	NullTerminatedField field(in);
+	const char *p = field.c_str();
+	double d;
+	if (!parseReal(p, d) || !onlyWhitespace(p)) {
+		return false;
+	}
+	r = d;
+	return true;
+}
+
+// Splits one line (without its newline) into fields and passes them on.
+// Returns false when reading should stop, either because the handler
+// asked to or because the line is empty, which marks the end of the data.
+static bool handleDelimitedLine(const char *begin, const char *end, const std::string &delimiter, bool removeQuotes,
+	DelimitedRowHandler &handler, std::vector<StringView> &fields, std::string &scratch)
+{
+	// remove '\r' characters to make DOS/Windows style returns look like unix
+	if (memchr(begin, '\r', end - begin) != NULL) {
+		scratch.assign(begin, end);
+		scratch.erase(std::remove(scratch.begin(), scratch.end(), '\r'), scratch.end());
+		begin = scratch.data();
+		end = begin + scratch.size();
+	}
+
+	if (begin == end) {
+		return false;
+	}
+
+	fields.clear();
+	const char *pos = begin;
+	while (true) {
+		const char *delim = delimiter.empty() ? end : std::search(pos, end, delimiter.begin(), delimiter.end());
+		StringView item(pos, delim - pos);
+		if ((removeQuotes) && (item.size() > 0) && (item[0] == '"') && (item[item.size()-1] == '"')) {
+			item = StringView(item.data() + 1, (item.size() > 1) ? item.size() - 2 : 0);
 		}
-		else
-			done = true;
+		fields.push_back(item);
+
+		if (delim == end) {
+			break;
+		}
+		pos = delim + delimiter.size();
+
+		// a trailing comma means a trailing empty item, other trailing delimiters are ignored
+		if (pos == end && delimiter != ",") {
+			break;
+		}
+	}
+
+	return handler.handleRow(fields);
+}
+
+void parseDelimitedData(const char *begin, const char *end, const std::string &delimiter,
+	DelimitedRowHandler &handler, bool removeQuotes)
+{
+	std::vector<StringView> fields;
+	std::string scratch;
+	const char *pos = begin;
+	while (pos < end) {
+		const char *nl = (const char*)memchr(pos, '\n', end - pos);
+		const char *endofline = (nl != NULL) ? nl : end;
+		if (!handleDelimitedLine(pos, endofline, delimiter, removeQuotes, handler, fields, scratch)) {
+			return;
+		}
+		pos = endofline + 1;
+	}
+}
+
+bool readDelimitedFile(const std::string &filename, const std::string &delimiter,
+	DelimitedRowHandler &handler, bool removeQuotes)
+{
+	MappedFileRef file = FileSystem::getInstance().mapFile(filename);
+	if (file == nullptr) {
+		MINVR_LOG_ERROR("MVRCore", "Unable to open delimited file " << filename);
+		return false;
 	}
 
+	// the fields handed to handler point straight into the mapped file
+	parseDelimitedData(file->getData(), file->getData() + file->getSize(), delimiter, handler, removeQuotes);
+	return true;
+}
+
+// Collects rows into the 2D array returned by readDelimitedData()
+class DelimitedDataCollector : public DelimitedRowHandler
+{
+public:
+	DelimitedDataCollector(std::vector< std::vector< std::string> > &data) : _data(data) {}
+
+	bool handleRow(const std::vector<StringView> &fields) {
+		_data.push_back(std::vector<std::string>());
+		std::vector<std::string> &dataLine = _data.back();
+		dataLine.reserve(fields.size());
+		for (int i=0;i<fields.size();i++) {
+			dataLine.push_back(fields[i].str());
+		}
+		return true;
+	}
+
+private:
+	std::vector< std::vector< std::string> > &_data;
+};
+
+std::vector< std::vector< std::string > > readDelimitedData(const std::string &csvString, const std::string &delimiter,	bool removeQuotes)
+{
+	std::vector< std::vector< std::string> > data;
+	DelimitedDataCollector collector(data);
+	parseDelimitedData(csvString.data(), csvString.data() + csvString.size(), delimiter, collector, removeQuotes);
 	return data;
 }
 
 
 bool popUntilSemicolon(std::string &in, std::string &popped)
 {
-	int semi = in.find(";");
-	if (semi == in.npos)
+	StringTokenizer tokenizer(in);
+	StringView piece;
+	if (!tokenizer.nextUntilSemicolon(piece)) {
 		return false;
-	else {
-		popped = in.substr(0,semi);
-		in = in.substr(semi+1);
-		return true;
 	}
+	popped = piece.str();
+	in.erase(0, piece.size() + 1);
+	return true;
 }
 
 std::string	convertNewlinesAndTabsToSpaces(std::string input) 
@@ -408,16 +750,14 @@ std::string readWholeFile(const std::string& filename)
 	string instr;
 	if (MinVR::FileSystem::getInstance().exists(filename))
 	{
-		std::ifstream fIn;
-		fIn.open(filename.c_str(),std::ios::in);
-
-		if (!fIn) {
+		// one copy straight out of the mapped file
+		MappedFileRef file = MinVR::FileSystem::getInstance().mapFile(filename);
+		if (file == nullptr) {
 			MinVR::Logger::getInstance().assertMessage(false, "Error: Unable to load file");
 		}
-		std::stringstream ss;
-		ss << fIn.rdbuf();
-    
-		instr =  ss.str();
+		else {
+			instr.assign(file->getData(), file->getSize());
+		}
 	}
 	else
 	{  
@@ -14,6 +14,7 @@
 #include <Windows.h>
 #else
 #include <dirent.h>
+#include <sys/stat.h>
 #endif
 
 namespace MinVR {
@@ -53,7 +54,7 @@ std::vector<std::string> BasicFileSystem::listDirectory(
             if(directories && (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ) {
                 files.push_back(fd.cFileName);
             }
-            else if ((fd.dwFileAttributes & FILE_ATTRIBUTE_NORMAL))
+            else if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
             {
                 files.push_back(fd.cFileName);
             }
@@ -66,20 +67,31 @@ std::vector<std::string> BasicFileSystem::listDirectory(
 	if ((dir = opendir (path.c_str())) != NULL) {
 	  /* print all the files and directories within directory */
 	  while ((ent = readdir (dir)) != NULL) {
-		  if (directories && ent->d_type == DT_DIR)
+		  bool isDir = ent->d_type == DT_DIR;
+		  bool isFile = ent->d_type == DT_REG;
+		  if (ent->d_type == DT_LNK || ent->d_type == DT_UNKNOWN)
+		  {
+			  // Some file systems (e.g. NFS) don't report the type, and links need to be followed
+			  struct stat info;
+			  if (stat((path + "/" + ent->d_name).c_str(), &info) == 0)
+			  {
+				  isDir = S_ISDIR(info.st_mode);
+				  isFile = S_ISREG(info.st_mode);
+			  }
+		  }
+
+		  if (directories && isDir)
 		  {
 			  files.push_back(ent->d_name);
 		  }
-		  else if (ent->d_type == DT_REG)
+		  else if (isFile)
 		  {
 			  files.push_back(ent->d_name);
 		  }
 	  }
 	  closedir (dir);
-	} else {
-	  /* could not open directory */
-	  perror ("");
 	}
+	// A directory that can't be opened simply has no entries
 #endif
 
 	return files;
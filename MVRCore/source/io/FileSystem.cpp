@@ -57,14 +57,21 @@ FileSystem::~FileSystem() {
 }
 
 FileSystem& FileSystem::getInstance() {
-	FileSystem* fileSystem;
+	// Only the first call constructs the file system
 #ifdef USE_BOOST
-	fileSystem = new BoostFileSystem();
+	static std::auto_ptr<FileSystem> instance = std::auto_ptr<FileSystem>(new BoostFileSystem());
 #else
-	fileSystem = new BasicFileSystem();
+	static std::auto_ptr<FileSystem> instance = std::auto_ptr<FileSystem>(new BasicFileSystem());
 #endif
-	static std::auto_ptr<FileSystem> instance = std::auto_ptr<FileSystem>(fileSystem);
 	return *instance;
 }
 
+MappedFileRef FileSystem::mapFile(const std::string& fileName) {
+	MappedFileRef file(new MappedFile(fileName));
+	if (!file->isValid()) {
+		return nullptr;
+	}
+	return file;
+}
+
 } /* namespace MinVR */
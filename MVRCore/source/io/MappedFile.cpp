@@ -0,0 +1,150 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/source/io/MappedFile.cpp
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#include <io/MappedFile.h>
+
+#if defined(WIN32)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace MinVR {
+
+MappedFile::MappedFile(const std::string& fileName) : _data(NULL), _size(0), _valid(false)
+{
+#if defined(WIN32)
+	_mapping = NULL;
+	_file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (_file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(_file, &size)) {
+		return;
+	}
+	_size = (size_t)size.QuadPart;
+
+	// Empty files can't be mapped, but they are still valid files
+	if (_size > 0) {
+		_mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (_mapping == NULL) {
+			return;
+		}
+		_data = (const char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+		if (_data == NULL) {
+			return;
+		}
+	}
+	_valid = true;
+#else
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat info;
+	if ((fstat(fd, &info) == 0) && S_ISREG(info.st_mode)) {
+		_size = (size_t)info.st_size;
+
+		// Empty files can't be mapped, but they are still valid files
+		if (_size == 0) {
+			_valid = true;
+		}
+		else {
+			void* data = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED) {
+				_data = (const char*)data;
+				_valid = true;
+			}
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+#endif
+
+	if (!_valid) {
+		_size = 0;
+	}
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(WIN32)
+	if (_data != NULL) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mapping != NULL) {
+		CloseHandle(_mapping);
+	}
+	if (_file != INVALID_HANDLE_VALUE) {
+		CloseHandle(_file);
+	}
+#else
+	if (_data != NULL) {
+		munmap((void*)_data, _size);
+	}
+#endif
+}
+
+bool MappedFile::isValid() const
+{
+	return _valid;
+}
+
+const char* MappedFile::getData() const
+{
+	return _data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return _size;
+}
+
+} /* namespace MinVR */
@@ -0,0 +1,216 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/source/log/AsyncLogger.cpp
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#include <log/AsyncLogger.h>
+#include <sstream>
+#include <stdint.h>
+
+namespace MinVR {
+
+static size_t roundUpToPowerOfTwo(int n)
+{
+	size_t size = 2;
+	while (size < n) {
+		size <<= 1;
+	}
+	return size;
+}
+
+AsyncLogger::AsyncLogger(LoggerRef logger, int capacity) : _logger(logger), _ring(roundUpToPowerOfTwo(capacity)),
+	_enqueuePos(0), _dequeuePos(0), _numDropped(0), _numDroppedReported(0), _writerSleeping(false), _running(true) {
+	_mask = _ring.size() - 1;
+	for (size_t f = 0; f < _ring.size(); f++) {
+		_ring[f].sequence.store(f, std::memory_order_relaxed);
+	}
+	_writer = new Thread(&AsyncLogger::run, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+	{
+		UniqueMutexLock lock(_wakeMutex);
+		_running = false;
+		_wakeCond.notify_one();
+	}
+	_writer->join();
+	delete _writer;
+
+	// Anything that raced with shutdown is written here
+	writePending();
+	UniqueMutexLock lock(_writeMutex);
+	_logger->flush();
+}
+
+void AsyncLogger::init() {
+	UniqueMutexLock lock(_writeMutex);
+	_logger->init();
+}
+
+void AsyncLogger::log(const std::string& message,
+		const std::string& attributeName, const std::string& attributeValue) {
+	// Bounded MPSC queue after Dmitry Vyukov: a slot is free for the producer
+	// whose position matches its sequence, and ready for the writer once the
+	// producer has bumped the sequence one past that position.
+	size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+	Entry* entry;
+	for (;;) {
+		entry = &_ring[pos & _mask];
+		size_t seq = entry->sequence.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+		if (diff == 0) {
+			if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (diff < 0) {
+			_numDropped++;
+			return;
+		}
+		else {
+			pos = _enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	entry->message = message;
+	entry->attributeName = attributeName;
+	entry->attributeValue = attributeValue;
+	entry->sequence.store(pos + 1, std::memory_order_seq_cst);
+
+	if (_writerSleeping.load(std::memory_order_seq_cst)) {
+		wakeWriter();
+	}
+}
+
+void AsyncLogger::assertMessage(bool expression, const std::string& message) {
+	if (!expression) {
+		// Make sure everything leading up to the failure reaches the log before asserting
+		flush();
+		UniqueMutexLock lock(_writeMutex);
+		_logger->assertMessage(expression, message);
+	}
+}
+
+void AsyncLogger::flush() {
+	size_t target = _enqueuePos.load();
+	if (!_running) {
+		writePending();
+	}
+	else {
+		UniqueMutexLock lock(_wakeMutex);
+		_wakeCond.notify_one();
+		while (_dequeuePos.load() < target && _running) {
+			_drainedCond.wait(lock);
+		}
+	}
+
+	UniqueMutexLock lock(_writeMutex);
+	_logger->flush();
+}
+
+unsigned long long AsyncLogger::getNumDropped() const {
+	return _numDropped.load();
+}
+
+void AsyncLogger::wakeWriter() {
+	UniqueMutexLock lock(_wakeMutex);
+	_wakeCond.notify_one();
+}
+
+bool AsyncLogger::writePending() {
+	UniqueMutexLock lock(_writeMutex);
+	bool wrote = false;
+
+	unsigned long long dropped = _numDropped.load();
+	if (dropped != _numDroppedReported) {
+		std::stringstream ss;
+		ss << "Log queue full, dropped " << dropped - _numDroppedReported << " messages";
+		_logger->log(ss.str(), "tag", "MVRCore");
+		_numDroppedReported = dropped;
+		wrote = true;
+	}
+
+	for (;;) {
+		size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+		Entry& entry = _ring[pos & _mask];
+		if (entry.sequence.load(std::memory_order_seq_cst) != pos + 1) {
+			break;
+		}
+
+		_logger->log(entry.message, entry.attributeName, entry.attributeValue);
+		entry.message.clear();
+		entry.sequence.store(pos + _ring.size(), std::memory_order_release);
+		_dequeuePos.store(pos + 1);
+		wrote = true;
+	}
+
+	// One flush per batch instead of one per line
+	if (wrote) {
+		_logger->flush();
+	}
+	return wrote;
+}
+
+void AsyncLogger::run() {
+	while (_running) {
+		if (writePending()) {
+			UniqueMutexLock lock(_wakeMutex);
+			_drainedCond.notify_all();
+			continue;
+		}
+
+		UniqueMutexLock lock(_wakeMutex);
+		_drainedCond.notify_all();
+		_writerSleeping = true;
+		// Re-check after announcing sleep, a producer that missed the flag has published by now
+		size_t pos = _dequeuePos.load();
+		bool pending = _ring[pos & _mask].sequence.load(std::memory_order_seq_cst) == pos + 1;
+		if (!pending && _running) {
+			_wakeCond.wait(lock);
+		}
+		_writerSleeping = false;
+	}
+
+	UniqueMutexLock lock(_wakeMutex);
+	_drainedCond.notify_all();
+}
+
+} /* namespace MinVR */
@@ -46,11 +46,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace MinVR {
 
-BasicLogger::BasicLogger(std::shared_ptr< std::ostream > stream) : _ostreamPtr(stream) {
+BasicLogger::BasicLogger(std::shared_ptr< std::ostream > stream, bool autoFlush) : _ostreamPtr(stream), _autoFlush(autoFlush) {
 	_ostream = _ostreamPtr.get();
 }
 
-BasicLogger::BasicLogger(std::ostream *stream) : _ostream(stream) {
+BasicLogger::BasicLogger(std::ostream *stream, bool autoFlush) : _ostream(stream), _autoFlush(autoFlush) {
 }
 
 BasicLogger::~BasicLogger() {
@@ -63,8 +63,10 @@ void BasicLogger::init()
 void BasicLogger::log(const std::string& message, const std::string& attributeName, const std::string& attributeValue)
 {
 	std::ostream& stream = getStream();
-	stream << attributeName << " " << attributeValue << ": " << message << std::endl;
-	stream.flush();
+	stream << attributeName << " " << attributeValue << ": " << message << '\n';
+	if (_autoFlush) {
+		stream.flush();
+	}
 }
 
 void BasicLogger::assertMessage(bool expression, const std::string& message)
@@ -78,6 +80,16 @@ void BasicLogger::assertMessage(bool expression, const std::string& message)
 	}
 }
 
+void BasicLogger::flush()
+{
+	getStream().flush();
+}
+
+void BasicLogger::setAutoFlush(bool autoFlush)
+{
+	_autoFlush = autoFlush;
+}
+
 std::ostream& BasicLogger::getStream() {
 	return *_ostream;
 }
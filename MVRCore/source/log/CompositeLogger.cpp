@@ -71,6 +71,13 @@ void CompositeLogger::assertMessage(bool expression,
 	}
 }
 
+void CompositeLogger::flush() {
+	for (int f = 0; f < _loggers.size(); f++)
+	{
+		_loggers[f]->flush();
+	}
+}
+
 void CompositeLogger::addLogger(LoggerRef logger) {
 	_loggers.push_back(logger);
 }
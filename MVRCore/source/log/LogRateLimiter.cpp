@@ -0,0 +1,210 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/source/log/LogRateLimiter.cpp
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#include <log/LogRateLimiter.h>
+#include <sstream>
+
+namespace MinVR {
+
+// Bounds the memory used by call sites that log many distinct messages
+static const size_t maxEntries = 1024;
+
+LogRateLimiter::LogRateLimiter(double intervalSeconds, int maxPerInterval) : _numEntries(0),
+	_interval(intervalSeconds), _maxPerInterval(maxPerInterval) {
+	_intervalStart = getCurrentTime();
+}
+
+LogRateLimiter::~LogRateLimiter() {
+	flush();
+}
+
+LogRateLimiter& LogRateLimiter::getInstance() {
+	static LogRateLimiter instance;
+	return instance;
+}
+
+void LogRateLimiter::log(LogLevel level, const char* tag, const char* file, int line, const std::string& message) {
+	std::vector<Line> lines;
+	{
+		UniqueMutexLock lock(_mutex);
+		TimeStamp now = getCurrentTime();
+		updateInterval(now, lines);
+
+		SiteKey key = { file, line };
+		SiteTable::iterator site = _sites.find(key);
+		if (site == _sites.end()) {
+			Site newSite;
+			newSite.loggedThisInterval = 0;
+			newSite.dropped = 0;
+			newSite.droppedLevel = level;
+			site = _sites.insert(std::make_pair(key, newSite)).first;
+		}
+
+		bool underLimit = site->second.loggedThisInterval < _maxPerInterval;
+		std::unordered_map<std::string, Entry>::iterator it = site->second.entries.find(message);
+		if (it == site->second.entries.end()) {
+			if (!underLimit) {
+				// Not remembered, so a message with a changing value can't fill up the table
+				site->second.dropped++;
+				site->second.droppedLevel = level;
+				site->second.droppedTag = tag;
+			}
+			else {
+				if (_numEntries >= maxEntries) {
+					flush(now, false, lines);
+					for (SiteTable::iterator s = _sites.begin(); s != _sites.end(); ++s) {
+						s->second.entries.clear();
+					}
+					_numEntries = 0;
+				}
+				Entry entry;
+				entry.level = level;
+				entry.tag = tag;
+				entry.suppressed = 0;
+				entry.lastLogged = now;
+				site->second.entries.insert(std::make_pair(message, entry));
+				_numEntries++;
+				site->second.loggedThisInterval++;
+
+				Line first = { level, tag, message };
+				lines.push_back(first);
+			}
+		}
+		else {
+			Entry& entry = it->second;
+			bool repeatedTooSoon = getDurationSeconds(getDuration(now, entry.lastLogged)) < _interval;
+			entry.suppressed++;
+			if (!repeatedTooSoon && underLimit) {
+				addLine(message, entry, lines);
+				entry.suppressed = 0;
+				entry.lastLogged = now;
+				site->second.loggedThisInterval++;
+			}
+		}
+	}
+
+	writeLines(lines);
+}
+
+void LogRateLimiter::update() {
+	std::vector<Line> lines;
+	{
+		UniqueMutexLock lock(_mutex);
+		updateInterval(getCurrentTime(), lines);
+	}
+	writeLines(lines);
+}
+
+void LogRateLimiter::flush() {
+	std::vector<Line> lines;
+	{
+		UniqueMutexLock lock(_mutex);
+		flush(getCurrentTime(), false, lines);
+	}
+	writeLines(lines);
+}
+
+void LogRateLimiter::updateInterval(const TimeStamp& now, std::vector<Line>& lines) {
+	if (getDurationSeconds(getDuration(now, _intervalStart)) < _interval) {
+		return;
+	}
+	flush(now, true, lines);
+	for (SiteTable::iterator site = _sites.begin(); site != _sites.end(); ++site) {
+		site->second.loggedThisInterval = 0;
+	}
+	_intervalStart = now;
+}
+
+void LogRateLimiter::flush(const TimeStamp& now, bool forget, std::vector<Line>& lines) {
+	for (SiteTable::iterator site = _sites.begin(); site != _sites.end(); ++site) {
+		std::unordered_map<std::string, Entry>& entries = site->second.entries;
+		std::unordered_map<std::string, Entry>::iterator it = entries.begin();
+		while (it != entries.end()) {
+			Entry& entry = it->second;
+			if (entry.suppressed > 0) {
+				addLine(it->first, entry, lines);
+				entry.suppressed = 0;
+				entry.lastLogged = now;
+				++it;
+			}
+			else if (forget && getDurationSeconds(getDuration(now, entry.lastLogged)) >= _interval) {
+				// Not seen for a whole interval, so the next occurrence is logged as new
+				it = entries.erase(it);
+				_numEntries--;
+			}
+			else {
+				++it;
+			}
+		}
+
+		if (site->second.dropped > 0) {
+			std::stringstream ss;
+			ss << site->second.dropped << " more messages from " << site->first.file << ":" << site->first.line << " were suppressed";
+			Line line = { site->second.droppedLevel, site->second.droppedTag, ss.str() };
+			lines.push_back(line);
+			site->second.dropped = 0;
+		}
+	}
+}
+
+void LogRateLimiter::addLine(const std::string& message, const Entry& entry, std::vector<Line>& lines) {
+	std::stringstream ss;
+	ss << message;
+	if (entry.suppressed > 1) {
+		ss << " (repeated " << entry.suppressed << " times)";
+	}
+	Line line = { entry.level, entry.tag, ss.str() };
+	lines.push_back(line);
+}
+
+void LogRateLimiter::writeLines(const std::vector<Line>& lines) {
+	for (size_t i = 0; i < lines.size(); i++) {
+		Logger::getInstance().logAtLevel(lines[i].level, lines[i].text, lines[i].tag);
+	}
+}
+
+void logRateLimited(LogLevel level, const char* tag, const char* file, int line, const std::string& message) {
+	LogRateLimiter::getInstance().log(level, tag, file, line, message);
+}
+
+} /* namespace MinVR */
@@ -42,11 +42,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ================================================================================ */
 
 #include <log/Logger.h>
+#include <MVRCore/Thread.h>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
 #ifdef USE_BOOST
 #include <Boost/BoostLogger.h>
 #else
 #include <log/BasicLogger.h>
-#include <log/ThreadSafeLogger.h>
+#include <log/AsyncLogger.h>
 #include <log/CompositeLogger.h>
 #include <fstream>
 #endif
@@ -57,15 +61,92 @@ Logger::~Logger() {
 	// TODO Auto-generated destructor stub
 }
 
+void Logger::flush() {
+}
+
+typedef std::unordered_map<std::string, int> LevelTable;
+
+// Tag thresholds are replaced as a whole, like the ConfigMap snapshots, so
+// readers never need a lock
+static std::shared_ptr<const LevelTable> tagLevels(new LevelTable());
+static std::atomic<int> defaultLevel(LOGLEVEL_INFO);
+static Mutex levelMutex;
+
+std::atomic<int> Logger::_minLevel(LOGLEVEL_INFO);
+
+static void updateMinLevel(const LevelTable& table, std::atomic<int>& minLevel)
+{
+	int level = defaultLevel;
+	for (LevelTable::const_iterator it = table.begin(); it != table.end(); ++it) {
+		level = std::min(level, it->second);
+	}
+	minLevel = level;
+}
+
+void Logger::setLevel(LogLevel level) {
+	UniqueMutexLock lock(levelMutex);
+	defaultLevel = level;
+	updateMinLevel(*std::atomic_load(&tagLevels), _minLevel);
+}
+
+void Logger::setLevel(const std::string& tag, LogLevel level) {
+	UniqueMutexLock lock(levelMutex);
+	std::shared_ptr<LevelTable> table(new LevelTable(*std::atomic_load(&tagLevels)));
+	(*table)[tag] = level;
+	updateMinLevel(*table, _minLevel);
+	std::atomic_store(&tagLevels, std::shared_ptr<const LevelTable>(table));
+}
+
+bool Logger::isEnabledForTag(LogLevel level, const char* tag) {
+	std::shared_ptr<const LevelTable> table = std::atomic_load(&tagLevels);
+	if (!table->empty()) {
+		LevelTable::const_iterator it = table->find(tag);
+		if (it != table->end()) {
+			return level >= it->second;
+		}
+	}
+	return level >= defaultLevel;
+}
+
+const char* Logger::getLevelName(LogLevel level) {
+	switch (level) {
+	case LOGLEVEL_TRACE: return "Trace";
+	case LOGLEVEL_DEBUG: return "Debug";
+	case LOGLEVEL_INFO: return "Info";
+	case LOGLEVEL_WARNING: return "Warning";
+	case LOGLEVEL_ERROR: return "Error";
+	default: return "Off";
+	}
+}
+
+bool Logger::parseLevel(const std::string& name, LogLevel& level) {
+	std::string lower = name;
+	std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+	for (int f = LOGLEVEL_TRACE; f <= LOGLEVEL_OFF; f++) {
+		std::string levelName = getLevelName((LogLevel)f);
+		std::transform(levelName.begin(), levelName.end(), levelName.begin(), ::tolower);
+		if (lower == levelName) {
+			level = (LogLevel)f;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Logger::logAtLevel(LogLevel level, const std::string& message, const std::string& tag) {
+	log(std::string(getLevelName(level)) + ": " + message, "tag", tag);
+}
+
 inline Logger* getLogger()
 {
 #ifdef USE_BOOST
-	return new BoostLogger()
+	return new BoostLogger();
 #else
+	// The writer thread flushes once per batch, so the streams don't need to flush every line
 	CompositeLogger* compositeLogger = new CompositeLogger();
-	compositeLogger->addLogger(LoggerRef(new BasicLogger()));
-	compositeLogger->addLogger(LoggerRef(new BasicLogger(std::shared_ptr< std::ostream >(new std::ofstream("log.txt")))));
-	return new ThreadSafeLogger(LoggerRef(compositeLogger));
+	compositeLogger->addLogger(LoggerRef(new BasicLogger(&std::cout, false)));
+	compositeLogger->addLogger(LoggerRef(new BasicLogger(std::shared_ptr< std::ostream >(new std::ofstream("log.txt")), false)));
+	return new AsyncLogger(LoggerRef(compositeLogger));
 #endif
 }
 
@@ -71,4 +71,10 @@ void ThreadSafeLogger::assertMessage(bool expression,
 	_mutex.unlock();
 }
 
+void ThreadSafeLogger::flush() {
+	_mutex.lock();
+	_logger->flush();
+	_mutex.unlock();
+}
+
 } /* namespace MinVR */
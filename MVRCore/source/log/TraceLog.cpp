@@ -0,0 +1,225 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/source/log/TraceLog.cpp
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+#include <log/TraceLog.h>
+#include <MVRCore/Thread.h>
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+
+namespace MinVR {
+
+namespace {
+
+struct TraceFormat {
+	std::string format;
+	std::string file;
+	uint32_t line;
+};
+
+// Owned by one thread, locked by it per record and by flush()
+struct TraceBuffer {
+	Mutex mutex;
+	std::vector<char> data;
+	size_t used;
+	size_t pending;
+	uint32_t threadIndex;
+};
+
+const size_t bufferSize = 64 * 1024;
+
+// Lock order is buffer mutex, then fileMutex
+Mutex fileMutex;
+FILE* traceFile = nullptr;
+std::vector<TraceFormat> formats;
+// Buffers of exited threads are kept so that their last records are still written
+std::vector<TraceBuffer*> buffers;
+std::chrono::steady_clock::time_point startTime;
+
+THREAD_LOCAL TraceBuffer* threadBuffer = nullptr;
+
+void writeFormat(uint32_t id, const TraceFormat& format)
+{
+	uint8_t type = TraceLog::BLOCK_FORMAT;
+	uint16_t fileLength = (uint16_t)format.file.size();
+	uint16_t formatLength = (uint16_t)format.format.size();
+	fwrite(&type, sizeof(type), 1, traceFile);
+	fwrite(&id, sizeof(id), 1, traceFile);
+	fwrite(&format.line, sizeof(format.line), 1, traceFile);
+	fwrite(&fileLength, sizeof(fileLength), 1, traceFile);
+	fwrite(format.file.data(), 1, fileLength, traceFile);
+	fwrite(&formatLength, sizeof(formatLength), 1, traceFile);
+	fwrite(format.format.data(), 1, formatLength, traceFile);
+}
+
+// The caller holds buffer->mutex
+void writeBuffer(TraceBuffer* buffer)
+{
+	UniqueMutexLock lock(fileMutex);
+	if (traceFile != nullptr && buffer->used > 0) {
+		uint8_t type = TraceLog::BLOCK_DATA;
+		uint32_t size = (uint32_t)buffer->used;
+		fwrite(&type, sizeof(type), 1, traceFile);
+		fwrite(&buffer->threadIndex, sizeof(buffer->threadIndex), 1, traceFile);
+		fwrite(&size, sizeof(size), 1, traceFile);
+		fwrite(&buffer->data[0], 1, buffer->used, traceFile);
+	}
+	buffer->used = 0;
+}
+
+struct TraceLogCloser {
+	~TraceLogCloser() {
+		TraceLog::close();
+	}
+} traceLogCloser;
+
+}
+
+std::atomic<bool> TraceLog::_enabled(false);
+
+bool TraceLog::open(const std::string& filename)
+{
+	close();
+
+	UniqueMutexLock lock(fileMutex);
+	traceFile = fopen(filename.c_str(), "wb");
+	if (traceFile == nullptr) {
+		return false;
+	}
+
+	fwrite("MVRTRACE", 1, 8, traceFile);
+	uint32_t version = VERSION;
+	fwrite(&version, sizeof(version), 1, traceFile);
+	for (size_t f = 0; f < formats.size(); f++) {
+		writeFormat((uint32_t)f, formats[f]);
+	}
+
+	startTime = std::chrono::steady_clock::now();
+	_enabled = true;
+	return true;
+}
+
+void TraceLog::close()
+{
+	_enabled = false;
+	flush();
+
+	UniqueMutexLock lock(fileMutex);
+	if (traceFile != nullptr) {
+		fclose(traceFile);
+		traceFile = nullptr;
+	}
+}
+
+void TraceLog::flush()
+{
+	std::vector<TraceBuffer*> allBuffers;
+	{
+		UniqueMutexLock lock(fileMutex);
+		allBuffers = buffers;
+	}
+
+	for (size_t f = 0; f < allBuffers.size(); f++) {
+		UniqueMutexLock bufferLock(allBuffers[f]->mutex);
+		writeBuffer(allBuffers[f]);
+	}
+
+	UniqueMutexLock lock(fileMutex);
+	if (traceFile != nullptr) {
+		fflush(traceFile);
+	}
+}
+
+uint32_t TraceLog::registerFormat(const char* format, const char* file, int line)
+{
+	UniqueMutexLock lock(fileMutex);
+	TraceFormat traceFormat;
+	traceFormat.format = format;
+	traceFormat.file = file;
+	traceFormat.line = line;
+	uint32_t id = (uint32_t)formats.size();
+	formats.push_back(traceFormat);
+	if (traceFile != nullptr) {
+		writeFormat(id, traceFormat);
+	}
+	return id;
+}
+
+char* TraceLog::beginRecord(size_t size)
+{
+	TraceBuffer* buffer = threadBuffer;
+	if (buffer == nullptr) {
+		buffer = new TraceBuffer();
+		buffer->data.resize(bufferSize);
+		buffer->used = 0;
+		buffer->pending = 0;
+		UniqueMutexLock lock(fileMutex);
+		buffer->threadIndex = (uint32_t)buffers.size();
+		buffers.push_back(buffer);
+		threadBuffer = buffer;
+	}
+
+	buffer->mutex.lock();
+	if (buffer->used + size > buffer->data.size()) {
+		writeBuffer(buffer);
+		if (size > buffer->data.size()) {
+			buffer->data.resize(size);
+		}
+	}
+	buffer->pending = size;
+	return &buffer->data[buffer->used];
+}
+
+void TraceLog::endRecord()
+{
+	TraceBuffer* buffer = threadBuffer;
+	buffer->used += buffer->pending;
+	buffer->mutex.unlock();
+}
+
+uint64_t TraceLog::getTimestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+} /* namespace MinVR */
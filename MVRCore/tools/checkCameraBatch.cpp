@@ -0,0 +1,272 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/tools/checkCameraBatch.cpp
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+// Checks that CameraOffAxisBatch calculates the same matrices as
+// CameraOffAxis::updateHeadTrackingFrame, and times both.  Random display
+// tiles are viewed from random head frames.  In double precision the
+// projection and view matrices of every eye, and their single precision
+// copies, must be bit identical.  The single precision batch is timed and
+// its largest difference is reported, but it is not expected to be exact.
+//
+// Usage: checkCameraBatch [tiles] [frames] [seed]
+//
+// Exits with 1 if the double precision batch differs from the cameras.
+
+#include <MVRCore/CameraOffAxisBatch.H>
+#include <MVRCore/CameraUniformBlock.H>
+#include <MVRCore/Time.h>
+#include <glm/gtc/quaternion.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace MinVR;
+
+static std::mt19937 rng;
+
+static double randomDouble(double low, double high)
+{
+	return std::uniform_real_distribution<double>(low, high)(rng);
+}
+
+static glm::dquat randomRotation()
+{
+	glm::dquat q(randomDouble(-1.0, 1.0), randomDouble(-1.0, 1.0), randomDouble(-1.0, 1.0), randomDouble(-1.0, 1.0));
+	return glm::normalize(q);
+}
+
+struct Tile {
+	glm::dvec3 topLeft, topRight, botLeft, botRight;
+	double iod, nearClip, farClip;
+};
+
+// The walls of a CAVE: axis aligned, and often centered, so that many matrix entries are exactly zero
+static glm::dmat3 randomWallRotation()
+{
+	static const glm::dmat3 walls[] = {
+		glm::dmat3(1.0),
+		glm::dmat3(0, 0, 1, 0, 1, 0, -1, 0, 0),
+		glm::dmat3(0, 0, -1, 0, 1, 0, 1, 0, 0),
+		glm::dmat3(-1, 0, 0, 0, 1, 0, 0, 0, -1),
+		glm::dmat3(1, 0, 0, 0, 0, -1, 0, 1, 0)
+	};
+	return walls[rng() % 5];
+}
+
+// A tile facing the origin from 1 to 5 units away, so the heads below are always in front of it
+static Tile randomTile()
+{
+	bool wall = rng() % 2 == 0;
+	glm::dmat3 rotation = wall ? randomWallRotation() : glm::mat3_cast(randomRotation());
+	glm::dvec3 offset(randomDouble(-2.0, 2.0), randomDouble(-2.0, 2.0), -randomDouble(1.0, 5.0));
+	if (wall && rng() % 2 == 0) {
+		offset = glm::dvec3(0.0, 0.0, -(double)(1 + rng() % 4));
+	}
+	glm::dvec3 center = rotation * offset;
+	glm::dvec3 right = rotation[0] * randomDouble(0.25, 2.0);
+	glm::dvec3 up = rotation[1] * randomDouble(0.25, 2.0);
+
+	Tile tile;
+	tile.topLeft = center - right + up;
+	tile.topRight = center + right + up;
+	tile.botLeft = center - right - up;
+	tile.botRight = center + right - up;
+	tile.iod = randomDouble(0.0, 0.1);
+	tile.nearClip = randomDouble(0.01, 0.5);
+	tile.farClip = (rng() % 4 == 0) ? std::numeric_limits<double>::max() : randomDouble(10.0, 1000.0);
+	return tile;
+}
+
+// Random head frames, and ones looking straight ahead from the center of the room or along its axes
+static glm::dmat4 randomHeadFrame()
+{
+	glm::dmat4 frame(1.0);
+	if (rng() % 2 == 0) {
+		frame = glm::mat4_cast(randomRotation());
+	}
+	for (int c = 0; c < 3; c++) {
+		int choice = rng() % 4;
+		frame[3][c] = (choice == 0) ? 0.0 : ((choice == 1) ? -0.0 : randomDouble(-0.4, 0.4));
+	}
+	return frame;
+}
+
+static std::vector<AbstractCameraRef> createCameras(const std::vector<Tile>& tiles, bool singlePrecision)
+{
+	std::vector<AbstractCameraRef> cameras;
+	for (size_t i = 0; i < tiles.size(); i++) {
+		const Tile& tile = tiles[i];
+		// Core profile, so applying the matrices does not need an OpenGL context
+		CameraOffAxis* camera = new CameraOffAxis(tile.topLeft, tile.topRight, tile.botLeft, tile.botRight,
+			glm::dmat4(1.0), tile.iod, tile.nearClip, tile.farClip, true);
+		camera->setSinglePrecision(singlePrecision);
+		cameras.push_back(AbstractCameraRef(camera));
+	}
+	return cameras;
+}
+
+struct EyeMatrices {
+	glm::dmat4 projection;
+	glm::dmat4 view;
+	CameraUniformBlock block;
+};
+
+static void getEyeMatrices(AbstractCameraRef cameraRef, int eye, EyeMatrices& matrices)
+{
+	CameraOffAxis* camera = static_cast<CameraOffAxis*>(cameraRef.get());
+	if (eye == CameraUniformBlock::EYE_LEFT) {
+		camera->applyProjectionAndCameraMatricesForLeftEye();
+	}
+	else if (eye == CameraUniformBlock::EYE_RIGHT) {
+		camera->applyProjectionAndCameraMatricesForRightEye();
+	}
+	else {
+		camera->applyProjectionAndCameraMatrices();
+	}
+	matrices.projection = camera->getLastAppliedProjectionMatrix();
+	matrices.view = camera->getLastAppliedViewMatrix();
+	memset(&matrices.block, 0, sizeof(matrices.block));
+	camera->getUniformBlock(matrices.block);
+}
+
+static double maxDifference(const glm::dmat4& a, const glm::dmat4& b)
+{
+	double difference = 0.0;
+	for (int c = 0; c < 4; c++) {
+		for (int r = 0; r < 4; r++) {
+			difference = std::max(difference, fabs(a[c][r] - b[c][r]) / std::max(1.0, fabs(a[c][r])));
+		}
+	}
+	return difference;
+}
+
+int main(int argc, char** argv)
+{
+	int numTiles = (argc > 1) ? atoi(argv[1]) : 37;
+	int numFrames = (argc > 2) ? atoi(argv[2]) : 1000;
+	unsigned int seed = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 10) : 1;
+	rng.seed(seed);
+
+	std::vector<Tile> tiles;
+	for (int i = 0; i < numTiles; i++) {
+		tiles.push_back(randomTile());
+	}
+	std::vector<glm::dmat4> headFrames;
+	for (int f = 0; f < numFrames; f++) {
+		headFrames.push_back(randomHeadFrame());
+	}
+
+	std::vector<AbstractCameraRef> cameras = createCameras(tiles, false);
+	std::vector<AbstractCameraRef> batchCameras = createCameras(tiles, false);
+	std::vector<AbstractCameraRef> floatCameras = createCameras(tiles, true);
+	CameraOffAxisBatch batch;
+	CameraOffAxisBatch floatBatch;
+	floatBatch.setSinglePrecision(true);
+
+	// Exactness, including frames where the head did not move and the update is skipped
+	int numMismatches = 0;
+	double maxFloatDifference = 0.0;
+	for (int f = 0; f < numFrames; f++) {
+		const glm::dmat4& headFrame = headFrames[(f % 10 == 9) ? f - 1 : f];
+		for (int i = 0; i < numTiles; i++) {
+			cameras[i]->updateHeadTrackingFrame(headFrame);
+		}
+		batch.updateHeadTrackingFrame(batchCameras, headFrame);
+		floatBatch.updateHeadTrackingFrame(floatCameras, headFrame);
+
+		for (int i = 0; i < numTiles; i++) {
+			for (int eye = 0; eye < 3; eye++) {
+				EyeMatrices expected, batched, floats;
+				getEyeMatrices(cameras[i], eye, expected);
+				getEyeMatrices(batchCameras[i], eye, batched);
+				getEyeMatrices(floatCameras[i], eye, floats);
+
+				bool same = memcmp(&expected.projection, &batched.projection, sizeof(glm::dmat4)) == 0 &&
+					memcmp(&expected.view, &batched.view, sizeof(glm::dmat4)) == 0 &&
+					memcmp(&expected.block, &batched.block, sizeof(CameraUniformBlock)) == 0;
+				if (!same) {
+					numMismatches++;
+					if (numMismatches <= 10) {
+						printf("Mismatch in frame %d, tile %d, eye %d: projection %g, view %g\n", f, i, eye,
+							maxDifference(expected.projection, batched.projection), maxDifference(expected.view, batched.view));
+					}
+				}
+				maxFloatDifference = std::max(maxFloatDifference, maxDifference(expected.projection, floats.projection));
+				maxFloatDifference = std::max(maxFloatDifference, maxDifference(expected.view, floats.view));
+			}
+		}
+	}
+	printf("%d tiles, %d frames checked with seed %u, %d mismatching eyes\n", numTiles, numFrames, seed, numMismatches);
+	printf("Single precision batch: largest relative difference %g\n", maxFloatDifference);
+
+	// Timing, with the head moving every frame
+	TimeStamp start = getCurrentTime();
+	for (int f = 0; f < numFrames; f++) {
+		for (int i = 0; i < numTiles; i++) {
+			cameras[i]->updateHeadTrackingFrame(headFrames[(f + 1) % numFrames]);
+		}
+	}
+	double cameraSeconds = getDurationSeconds(getDuration(getCurrentTime(), start));
+
+	start = getCurrentTime();
+	for (int f = 0; f < numFrames; f++) {
+		batch.updateHeadTrackingFrame(batchCameras, headFrames[(f + 1) % numFrames]);
+	}
+	double batchSeconds = getDurationSeconds(getDuration(getCurrentTime(), start));
+
+	start = getCurrentTime();
+	for (int f = 0; f < numFrames; f++) {
+		floatBatch.updateHeadTrackingFrame(floatCameras, headFrames[(f + 1) % numFrames]);
+	}
+	double floatSeconds = getDurationSeconds(getDuration(getCurrentTime(), start));
+
+	printf("Per camera: %.2f us per frame\n", 1e6 * cameraSeconds / numFrames);
+	printf("Batch: %.2f us per frame, %.1fx\n", 1e6 * batchSeconds / numFrames, cameraSeconds / batchSeconds);
+	printf("Single precision batch: %.2f us per frame, %.1fx\n", 1e6 * floatSeconds / numFrames, cameraSeconds / floatSeconds);
+
+	return (numMismatches == 0) ? 0 : 1;
+}
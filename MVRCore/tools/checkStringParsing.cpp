@@ -0,0 +1,300 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/tools/checkStringParsing.cpp
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+// Checks that parseString reads the glm vector and matrix types exactly like
+// the operator>> overloads it replaces, and times both.  The inputs are text
+// written by operator<<, with random separators and whitespace, and mutated
+// copies of it with characters inserted, removed, replaced or cut off.  For
+// every input both must fail, or both must succeed with bit identical values.
+//
+// Usage: checkStringParsing [iterations] [seed]
+//
+// Exits with 1 if any input is parsed differently.
+
+#include <MVRCore/StringUtils.H>
+#include <MVRCore/Time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MinVR;
+
+static std::mt19937 rng;
+
+static int randomInt(int count)
+{
+	return std::uniform_int_distribution<int>(0, count - 1)(rng);
+}
+
+static double randomDouble()
+{
+	switch (randomInt(6)) {
+	case 0:
+		return (double)(randomInt(2001) - 1000);
+	case 1:
+		return std::uniform_real_distribution<double>(-1.0, 1.0)(rng);
+	case 2:
+		// very large and very small magnitudes, including values near the limits
+		return std::uniform_real_distribution<double>(-1.0, 1.0)(rng) * pow(10.0, randomInt(617) - 308);
+	case 3:
+		return 0.0;
+	case 4:
+		return -0.0;
+	default:
+		return std::uniform_real_distribution<double>(-1e6, 1e6)(rng);
+	}
+}
+
+// Number text as written by operator<< at some precision, or in a form it never writes
+static std::string randomNumber()
+{
+	std::ostringstream ss;
+	switch (randomInt(4)) {
+	case 0:
+		ss << randomDouble();
+		break;
+	case 1:
+		ss.precision(17);
+		ss << randomDouble();
+		break;
+	case 2:
+		ss << std::scientific << randomDouble();
+		break;
+	default:
+	{
+		static const char* const special[] = { "1e", "1e+", ".5", "5.", "-.5", "+3", "1e400", "-1e400", "1e-400",
+			"0x1p3", "inf", "nan", "-", ".", "1.2.3", "00012", "1E5", "4e-320" };
+		ss << special[randomInt(sizeof(special) / sizeof(special[0]))];
+		break;
+	}
+	}
+	return ss.str();
+}
+
+static std::string randomSpace()
+{
+	static const char* const spaces[] = { "", "", "", " ", "  ", "\t", "\n", " \r\n" };
+	return spaces[randomInt(sizeof(spaces) / sizeof(spaces[0]))];
+}
+
+// A separator is any single non-whitespace character for operator>>
+static std::string randomSeparator(char usual)
+{
+	static const char others[] = ",;:()[]x";
+	std::string separator = randomSpace();
+	separator += (randomInt(8) == 0) ? others[randomInt(sizeof(others) - 1)] : usual;
+	return separator + randomSpace();
+}
+
+static std::string randomRow(int numCols)
+{
+	std::string row = randomSeparator('(');
+	for (int c = 0; c < numCols; c++) {
+		row += randomNumber();
+		row += randomSeparator((c + 1 < numCols) ? ',' : ')');
+	}
+	return row;
+}
+
+static std::string randomText(int numRows, int numCols)
+{
+	if (numRows == 1) {
+		return randomRow(numCols);
+	}
+	std::string text = randomSeparator('(');
+	for (int r = 0; r < numRows; r++) {
+		text += randomRow(numCols);
+		text += randomSeparator((r + 1 < numRows) ? ',' : ')');
+	}
+	return text;
+}
+
+static std::string mutate(std::string text)
+{
+	static const char alphabet[] = "0123456789.+-eE(),; \t\nxinfa";
+	int numMutations = 1 + randomInt(4);
+	for (int m = 0; m < numMutations; m++) {
+		int pos = text.empty() ? 0 : randomInt((int)text.size());
+		switch (randomInt(5)) {
+		case 0:
+			if (!text.empty()) {
+				text.erase(pos, 1);
+			}
+			break;
+		case 1:
+			text.insert(pos, 1, alphabet[randomInt(sizeof(alphabet) - 1)]);
+			break;
+		case 2:
+			if (!text.empty()) {
+				text[pos] = alphabet[randomInt(sizeof(alphabet) - 1)];
+			}
+			break;
+		case 3:
+			text.resize(pos);
+			break;
+		default:
+			text.insert(pos, text.substr(randomInt((int)text.size() + 1)));
+			break;
+		}
+	}
+	return text;
+}
+
+template <class T>
+static bool parseWithStream(const std::string& str, T& val)
+{
+	std::istringstream is(str.c_str());
+	is >> val;
+	return !is.fail();
+}
+
+static int numMismatches = 0;
+
+template <class T>
+static void compare(const std::string& text, const char* typeName)
+{
+	T streamVal, parsedVal;
+	bool streamOk = parseWithStream(text, streamVal);
+	bool parsedOk = parseString(text, parsedVal);
+	if (streamOk == parsedOk && (!streamOk || memcmp(&streamVal, &parsedVal, sizeof(T)) == 0)) {
+		return;
+	}
+
+	numMismatches++;
+	if (numMismatches <= 20) {
+		std::ostringstream ss;
+		ss.precision(17);
+		ss << typeName << " \"" << text << "\": operator>> ";
+		if (streamOk) {
+			ss << streamVal;
+		}
+		else {
+			ss << "failed";
+		}
+		ss << ", parseString ";
+		if (parsedOk) {
+			ss << parsedVal;
+		}
+		else {
+			ss << "failed";
+		}
+		printf("Mismatch for %s\n", ss.str().c_str());
+	}
+}
+
+static void compareAll(const std::string& text)
+{
+	compare<glm::dvec2>(text, "dvec2");
+	compare<glm::dvec3>(text, "dvec3");
+	compare<glm::dvec4>(text, "dvec4");
+	compare<glm::dmat3>(text, "dmat3");
+	compare<glm::dmat4>(text, "dmat4");
+}
+
+template <class T>
+static void time(const std::vector<std::string>& texts, const char* typeName)
+{
+	T val;
+	int numParsed = 0;
+	TimeStamp start = getCurrentTime();
+	for (size_t i = 0; i < texts.size(); i++) {
+		numParsed += parseWithStream(texts[i], val) ? 1 : 0;
+	}
+	double streamSeconds = getDurationSeconds(getDuration(getCurrentTime(), start));
+
+	start = getCurrentTime();
+	for (size_t i = 0; i < texts.size(); i++) {
+		numParsed += parseString(texts[i], val) ? 1 : 0;
+	}
+	double parseSeconds = getDurationSeconds(getDuration(getCurrentTime(), start));
+
+	printf("%s: operator>> %.3f us, parseString %.3f us per value, %.1fx (%d parsed)\n", typeName,
+		1e6 * streamSeconds / texts.size(), 1e6 * parseSeconds / texts.size(), streamSeconds / parseSeconds, numParsed);
+}
+
+template <class T>
+static void timeWritten(int count, const char* typeName)
+{
+	// Text as the engine reads it, written by operator<<
+	std::vector<std::string> texts;
+	for (int i = 0; i < count; i++) {
+		T val;
+		double* values = (double*)&val;
+		for (size_t v = 0; v < sizeof(T) / sizeof(double); v++) {
+			values[v] = randomDouble();
+		}
+		std::ostringstream ss;
+		ss << val;
+		texts.push_back(ss.str());
+	}
+	time<T>(texts, typeName);
+}
+
+int main(int argc, char** argv)
+{
+	int iterations = (argc > 1) ? atoi(argv[1]) : 100000;
+	unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+	rng.seed(seed);
+
+	static const int shapes[][2] = { { 1, 2 }, { 1, 3 }, { 1, 4 }, { 3, 3 }, { 4, 4 } };
+	for (int i = 0; i < iterations; i++) {
+		const int* shape = shapes[randomInt(5)];
+		std::string text = randomText(shape[0], shape[1]);
+		compareAll(text);
+		compareAll(mutate(text));
+	}
+	printf("%d inputs checked with seed %u, %d mismatches\n", 2 * iterations, seed, numMismatches);
+
+	int count = std::max(iterations / 10, 1000);
+	timeWritten<glm::dvec2>(count, "dvec2");
+	timeWritten<glm::dvec3>(count, "dvec3");
+	timeWritten<glm::dvec4>(count, "dvec4");
+	timeWritten<glm::dmat3>(count, "dmat3");
+	timeWritten<glm::dmat4>(count, "dmat4");
+
+	return (numMismatches == 0) ? 0 : 1;
+}
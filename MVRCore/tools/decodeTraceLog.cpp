@@ -0,0 +1,292 @@
+/* ================================================================================
+
+This file is part of the MinVR Open Source Project, which is developed and
+maintained by the University of Minnesota's Interactive Visualization Lab.
+
+File: MinVR/MVRCore/tools/decodeTraceLog.cpp
+
+Original Author(s) of this File:
+	MinVR Development Team, 2015, University of Minnesota
+
+Author(s) of Significant Updates/Modifications to the File:
+	...
+
+-----------------------------------------------------------------------------------
+Copyright (c) 2015 Regents of the University of Minnesota
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* The name of the University of Minnesota, nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+================================================================================ */
+
+// Formats a binary trace written by MinVR::TraceLog as text, one record per
+// line, ordered by timestamp:
+//
+//     <seconds> [thread <n>] <message> (<file>:<line>)
+//
+// Usage: decodeTraceLog <trace file> [output file]
+
+#include <log/TraceLog.h>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using MinVR::TraceLog;
+
+struct Format {
+	std::string format;
+	std::string file;
+	uint32_t line;
+};
+
+struct Record {
+	uint64_t timestamp;
+	uint32_t threadIndex;
+	std::string message;
+	uint32_t formatId;
+};
+
+class Reader {
+public:
+	Reader(const std::vector<char>& data) : _data(data), _pos(0) {}
+
+	bool atEnd() const { return _pos >= _data.size(); }
+
+	template<typename T>
+	bool read(T& value) {
+		if (_pos + sizeof(T) > _data.size()) {
+			return false;
+		}
+		memcpy(&value, &_data[_pos], sizeof(T));
+		_pos += sizeof(T);
+		return true;
+	}
+
+	bool readString(std::string& value) {
+		uint16_t length;
+		if (!read(length) || _pos + length > _data.size()) {
+			return false;
+		}
+		value.assign(&_data[0] + _pos, length);
+		_pos += length;
+		return true;
+	}
+
+	size_t position() const { return _pos; }
+
+private:
+	const std::vector<char>& _data;
+	size_t _pos;
+};
+
+static bool readArg(Reader& reader, std::string& text)
+{
+	uint8_t type;
+	if (!reader.read(type)) {
+		return false;
+	}
+
+	std::stringstream ss;
+	switch (type) {
+	case TraceLog::ARG_INT64: {
+		int64_t value;
+		if (!reader.read(value)) return false;
+		ss << value;
+		break;
+	}
+	case TraceLog::ARG_UINT64: {
+		uint64_t value;
+		if (!reader.read(value)) return false;
+		ss << value;
+		break;
+	}
+	case TraceLog::ARG_DOUBLE: {
+		double value;
+		if (!reader.read(value)) return false;
+		ss << value;
+		break;
+	}
+	case TraceLog::ARG_BOOL: {
+		uint8_t value;
+		if (!reader.read(value)) return false;
+		ss << (value ? "true" : "false");
+		break;
+	}
+	case TraceLog::ARG_STRING: {
+		std::string value;
+		if (!reader.readString(value)) return false;
+		ss << value;
+		break;
+	}
+	case TraceLog::ARG_POINTER: {
+		uint64_t value;
+		if (!reader.read(value)) return false;
+		ss << "0x" << std::hex << value;
+		break;
+	}
+	default:
+		return false;
+	}
+
+	text = ss.str();
+	return true;
+}
+
+static std::string formatMessage(const std::string& format, const std::vector<std::string>& args)
+{
+	std::string message;
+	size_t arg = 0;
+	for (size_t f = 0; f < format.size(); f++) {
+		if (format[f] == '{' && f + 1 < format.size() && format[f+1] == '}' && arg < args.size()) {
+			message += args[arg++];
+			f++;
+		}
+		else {
+			message += format[f];
+		}
+	}
+	// Arguments without a placeholder are appended rather than lost
+	for (; arg < args.size(); arg++) {
+		message += " " + args[arg];
+	}
+	return message;
+}
+
+static bool readDataBlock(Reader& reader, const std::map<uint32_t, Format>& formats, std::vector<Record>& records)
+{
+	uint32_t threadIndex, size;
+	if (!reader.read(threadIndex) || !reader.read(size)) {
+		return false;
+	}
+
+	size_t end = reader.position() + size;
+	while (reader.position() < end) {
+		Record record;
+		uint8_t numArgs;
+		record.threadIndex = threadIndex;
+		if (!reader.read(record.formatId) || !reader.read(record.timestamp) || !reader.read(numArgs)) {
+			return false;
+		}
+
+		std::vector<std::string> args(numArgs);
+		for (int f = 0; f < numArgs; f++) {
+			if (!readArg(reader, args[f])) {
+				return false;
+			}
+		}
+
+		std::map<uint32_t, Format>::const_iterator format = formats.find(record.formatId);
+		if (format == formats.end()) {
+			std::stringstream ss;
+			ss << "<unknown format " << record.formatId << ">";
+			record.message = formatMessage(ss.str(), args);
+		}
+		else {
+			record.message = formatMessage(format->second.format, args);
+		}
+		records.push_back(record);
+	}
+	return reader.position() == end;
+}
+
+static bool compareRecords(const Record& a, const Record& b)
+{
+	return a.timestamp < b.timestamp;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <trace file> [output file]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream input(argv[1], std::ios::binary);
+	if (!input) {
+		std::cerr << "Unable to open " << argv[1] << std::endl;
+		return 1;
+	}
+	std::vector<char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+	Reader reader(data);
+	char magic[8];
+	uint32_t version;
+	if (!reader.read(magic) || memcmp(magic, "MVRTRACE", 8) != 0 || !reader.read(version) || version != TraceLog::VERSION) {
+		std::cerr << argv[1] << " is not a MinVR trace log (version " << TraceLog::VERSION << ")" << std::endl;
+		return 1;
+	}
+
+	std::map<uint32_t, Format> formats;
+	std::vector<Record> records;
+	bool complete = true;
+	while (!reader.atEnd()) {
+		uint8_t type;
+		reader.read(type);
+		if (type == TraceLog::BLOCK_FORMAT) {
+			uint32_t id;
+			Format format;
+			if (!reader.read(id) || !reader.read(format.line) || !reader.readString(format.file) || !reader.readString(format.format)) {
+				complete = false;
+				break;
+			}
+			formats[id] = format;
+		}
+		else if (type != TraceLog::BLOCK_DATA || !readDataBlock(reader, formats, records)) {
+			complete = false;
+			break;
+		}
+	}
+
+	// Blocks are written per thread as their buffers fill, so records are only ordered within a block
+	std::stable_sort(records.begin(), records.end(), compareRecords);
+
+	std::ofstream outputFile;
+	if (argc > 2) {
+		outputFile.open(argv[2]);
+	}
+	std::ostream& output = argc > 2 ? outputFile : std::cout;
+
+	char timeText[32];
+	for (size_t f = 0; f < records.size(); f++) {
+		const Record& record = records[f];
+		snprintf(timeText, sizeof(timeText), "%.6f", record.timestamp / 1.0e9);
+		output << timeText << " [thread " << record.threadIndex << "] " << record.message;
+		std::map<uint32_t, Format>::const_iterator format = formats.find(record.formatId);
+		if (format != formats.end()) {
+			output << " (" << format->second.file << ":" << format->second.line << ")";
+		}
+		output << '\n';
+	}
+
+	if (!complete) {
+		std::cerr << "Warning: the trace is truncated or corrupt after " << records.size() << " records" << std::endl;
+	}
+	return 0;
+}
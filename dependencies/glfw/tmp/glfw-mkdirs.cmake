@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/dependencies/glfw/src/glfw"
+  "/root/repo/dependencies/glfw/src/glfw-build"
+  "/usr/local/MinVR/glfw"
+  "/root/repo/dependencies/glfw/tmp"
+  "/root/repo/dependencies/glfw/src/glfw-stamp"
+  "/root/repo/dependencies/glfw/src"
+  "/root/repo/dependencies/glfw/src/glfw-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/dependencies/glfw/src/glfw-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/dependencies/glfw/src/glfw-stamp${cfgdir}") # cfgdir has leading slash
+endif()